@@ -0,0 +1,333 @@
+/*
+ *  benchmark.cpp
+ *  Notification Center CPP
+ *
+ *  Throughput benchmarks of the asynchronous dispatch paths.
+ */
+
+#include "notifly.h"
+
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr int notifications = 8;
+
+    /**
+     * @brief               Post 'a_posts' notifications spread over 'notifications' ids with one observer each, and
+     *                      measure how long it takes until every observer has run.
+     * @return              The number of deliveries per second.
+     */
+    double run_throughput(const dispatch_mode a_mode, const int a_posts)
+    {
+        notifly center;
+        std::atomic_int delivered = 0;
+        for(int i = 0; i < notifications; ++i)
+        {
+            center.add_observer(i, [&delivered](const int){ delivered.fetch_add(1, std::memory_order_relaxed); });
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for(int i = 0; i < a_posts; ++i)
+        {
+            center.post_notification<int>(i % notifications, i, a_mode);
+        }
+        while(delivered.load(std::memory_order_relaxed) < a_posts)
+        {
+            std::this_thread::yield();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return a_posts / elapsed.count();
+    }
+
+    /**
+     * @brief               Post 'a_posts' asynchronous notifications carrying a string to 'a_observers' observers,
+     *                      either with a task and a payload copy per observer or through a ring, and measure how long
+     *                      it takes until every observer got every post.
+     * @return              The number of deliveries per second.
+     */
+    double run_fan_out(const bool a_ring, const int a_observers, const int a_posts)
+    {
+        notifly center;
+        std::atomic_int delivered = 0;
+        for(int i = 0; i < a_observers; ++i)
+        {
+            center.add_observer(0, [&delivered](std::string)
+            {
+                delivered.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        if(a_ring) center.set_ring_delivery(0, 4096);
+
+        const std::string payload(256, 'x');
+        const auto start = std::chrono::steady_clock::now();
+        for(int i = 0; i < a_posts; ++i)
+        {
+            while(center.post_notification<std::string>(0, payload, true) ==
+                  static_cast<int>(notifly_result::ring_full))
+            {
+                std::this_thread::yield();
+            }
+        }
+        while(delivered.load(std::memory_order_relaxed) < a_posts * a_observers)
+        {
+            std::this_thread::yield();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return a_posts * a_observers / elapsed.count();
+    }
+
+    /**
+     * @brief               Post 'a_posts' asynchronous notifications from a single thread to a single observer,
+     *                      through the thread pool or a single producer, single consumer channel, and measure how long
+     *                      it takes until the observer got all of them. Both paths post under the lock of the center,
+     *                      so only the cost of the delivery differs.
+     * @return              The number of deliveries per second.
+     */
+    double run_channel(const bool a_channel, const int a_posts)
+    {
+        notifly center;
+        std::atomic_int delivered = 0;
+        center.add_observer(0, [&delivered](int){ delivered.fetch_add(1, std::memory_order_relaxed); });
+        if(a_channel) center.set_spsc_channel(0, 4096);
+
+        const auto start = std::chrono::steady_clock::now();
+        for(int i = 0; i < a_posts; ++i)
+        {
+            while(center.post_notification<int>(0, i, true) == static_cast<int>(notifly_result::ring_full))
+            {
+                std::this_thread::yield();
+            }
+        }
+        while(delivered.load(std::memory_order_relaxed) < a_posts)
+        {
+            std::this_thread::yield();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return a_posts / elapsed.count();
+    }
+
+    /**
+     * @brief               Post 'a_posts' asynchronous notifications with post_notification(), or with try_post() from
+     *                      a real-time thread, and measure how long the posting thread spends in each call.
+     * @return              The mean and the worst time of a call in nanoseconds.
+     */
+    std::pair<double, double> run_poster_cost(const bool a_realtime, const int a_posts)
+    {
+        notifly center;
+        std::atomic_int delivered = 0;
+        center.add_observer(0, [&delivered](int){ delivered.fetch_add(1, std::memory_order_relaxed); });
+        if(a_realtime) center.set_realtime_posting(realtime_config{4096, std::chrono::microseconds(50)});
+
+        int64_t total = 0;
+        int64_t worst = 0;
+        for(int i = 0; i < a_posts; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            const auto result = a_realtime ? center.try_post<int>(0, i, true)
+                                           : center.post_notification<int>(0, i, true);
+            const auto elapsed = (std::chrono::steady_clock::now() - start).count();
+            total += elapsed;
+            worst = std::max<int64_t>(worst, elapsed);
+            // A refused post is retried, and the queue is kept from filling up, outside of the measured call.
+            if(result < 0) --i;
+            if(result < 0 || i % 1024 == 1023)
+            {
+                while(delivered.load(std::memory_order_relaxed) < i + 1)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        while(delivered.load(std::memory_order_relaxed) < a_posts)
+        {
+            std::this_thread::yield();
+        }
+        return {static_cast<double>(total) / a_posts, static_cast<double>(worst)};
+    }
+
+    /**
+     * @brief               Post 'a_posts' asynchronous notifications, one at a time with a pause in between so the
+     *                      executor goes idle, and measure how long each delivery takes to start.
+     * @return              The mean wake-up latency in nanoseconds.
+     */
+    double run_wakeup_latency(const bool a_busy_polling, const int a_posts, const executor_config& a_config = {})
+    {
+        notifly center(a_config);
+        std::atomic_int delivered = 0;
+        std::atomic<int64_t> total = 0;
+        center.add_observer(0, [&](const std::chrono::steady_clock::time_point a_posted)
+        {
+            total.fetch_add((std::chrono::steady_clock::now() - a_posted).count(), std::memory_order_relaxed);
+            delivered.fetch_add(1, std::memory_order_release);
+        });
+        if(a_busy_polling) center.set_busy_polling(0, true);
+
+        for(int i = 0; i < a_posts; ++i)
+        {
+            center.post_notification<std::chrono::steady_clock::time_point>(0, std::chrono::steady_clock::now(),
+                                                                             dispatch_mode::async);
+            while(delivered.load(std::memory_order_acquire) <= i)
+            {
+                std::this_thread::yield();
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        return static_cast<double>(total.load()) / a_posts;
+    }
+
+    /**
+     * @brief               Leave a center idle for a while and measure the CPU its workers burn meanwhile.
+     * @return              The number of cores kept busy.
+     */
+    double run_idle_cpu(const executor_config& a_config)
+    {
+        notifly center(a_config);
+        const auto cpu_start = std::clock();
+        const auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC / elapsed.count();
+    }
+
+    /**
+     * @brief   The queue the thread pool used before the lock-free ring: a std::queue behind a mutex.
+     */
+    class locked_queue
+    {
+    public:
+        bool try_push(std::function<void()>& a_task)
+        {
+            std::lock_guard lock(m_mutex);
+            m_tasks.push(std::move(a_task));
+            return true;
+        }
+
+        bool try_pop(std::function<void()>& a_task)
+        {
+            std::lock_guard lock(m_mutex);
+            if(m_tasks.empty()) return false;
+            a_task = std::move(m_tasks.front());
+            m_tasks.pop();
+            return true;
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::queue<std::function<void()>> m_tasks;
+    };
+
+    /**
+     * @brief               Push 'a_tasks' tasks from 'a_producers' threads while 4 threads pop and run them, and
+     *                      measure how long it takes until all of them ran.
+     * @return              The number of tasks per second.
+     */
+    template<typename Queue>
+    double run_queue_throughput(Queue& a_queue, const int a_producers, const int a_tasks)
+    {
+        constexpr int consumers = 4;
+        std::atomic_int ran = 0;
+        std::vector<std::thread> threads;
+
+        const auto start = std::chrono::steady_clock::now();
+        for(int producer = 0; producer < a_producers; ++producer)
+        {
+            threads.emplace_back([&]
+            {
+                for(int i = 0; i < a_tasks / a_producers; ++i)
+                {
+                    std::function<void()> task = [&ran]{ ran.fetch_add(1, std::memory_order_relaxed); };
+                    while(!a_queue.try_push(task)) std::this_thread::yield();
+                }
+            });
+        }
+        const auto total = a_tasks / a_producers * a_producers;
+        for(int consumer = 0; consumer < consumers; ++consumer)
+        {
+            threads.emplace_back([&]
+            {
+                std::function<void()> task;
+                while(ran.load(std::memory_order_relaxed) < total)
+                {
+                    if(a_queue.try_pop(task)) task();
+                    else std::this_thread::yield();
+                }
+            });
+        }
+        for(auto& thread : threads)
+        {
+            thread.join();
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return total / elapsed.count();
+    }
+
+    void report(const std::string& a_name, const double a_rate)
+    {
+        std::printf("%-40s %14.0f deliveries/s\n", a_name.c_str(), a_rate);
+    }
+
+    void report_latency(const std::string& a_name, const double a_nanoseconds)
+    {
+        std::printf("%-40s %14.0f ns\n", a_name.c_str(), a_nanoseconds);
+    }
+}
+
+int main()
+{
+    constexpr int posts = 200000;
+
+    report("async (shared pool)", run_throughput(dispatch_mode::async, posts));
+    report("sharded", run_throughput(dispatch_mode::sharded, posts));
+
+    report("single producer, thread pool", run_channel(false, posts));
+    report("single producer, SPSC channel", run_channel(true, posts));
+
+    for(const int observers : {1, 16})
+    {
+        const auto suffix = ", " + std::to_string(observers) + " observers";
+        report("fan-out, task per observer" + suffix, run_fan_out(false, observers, posts / observers));
+        report("fan-out, ring" + suffix, run_fan_out(true, observers, posts / observers));
+    }
+
+    constexpr int tasks = 400000;
+
+    for(const int producers : {1, 2, 4, 8, 16, 32, 64})
+    {
+        locked_queue locked;
+        mpmc_ring<std::function<void()>> ring(1024);
+        const auto suffix = ", " + std::to_string(producers) + " producers";
+        report("locked queue" + suffix, run_queue_throughput(locked, producers, tasks));
+        report("lock-free ring" + suffix, run_queue_throughput(ring, producers, tasks));
+    }
+
+    for(const bool realtime : {false, true})
+    {
+        const auto [mean, worst] = run_poster_cost(realtime, posts);
+        const std::string name = realtime ? "try_post" : "post_notification";
+        report_latency("poster cost, " + name, mean);
+        report_latency("poster worst case, " + name, worst);
+    }
+
+    constexpr int wakeups = 2000;
+
+    report_latency("wake-up, shared pool", run_wakeup_latency(false, wakeups));
+    report_latency("wake-up, busy polling", run_wakeup_latency(true, wakeups));
+
+    const std::pair<const char*, wait_strategy> strategies[] = {
+        {"spin", wait_strategy::spin},
+        {"spin then yield", wait_strategy::spin_then_yield},
+        {"park", wait_strategy::park},
+    };
+    for(const auto& [name, strategy] : strategies)
+    {
+        const executor_config config{4, strategy, 1000};
+        report_latency(std::string("wake-up, ") + name, run_wakeup_latency(false, wakeups, config));
+        std::printf("%-40s %14.2f cores\n", (std::string("idle CPU, ") + name).c_str(), run_idle_cpu(config));
+    }
+
+    return 0;
+}
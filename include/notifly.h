@@ -30,13 +30,42 @@
 #include <functional>
 #include <list>
 #include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
 #include <any>
+#include <chrono>
+#include <exception>
 #include <typeindex>
 #include <thread>
+#include <stop_token>
 #include <stack>
+#include <queue>
+#include <deque>
 #include <set>
+#include <map>
+#include <array>
+#include <type_traits>
 #include <memory>
-#include <PartyThreads.h>
+#include <utility>
+#include <vector>
+#include <span>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <bit>
+#include <cstring>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
 
 #define NOTIFLY_VERSION_MAJOR 2
 #define NOTIFLY_VERSION_MINOR 0
@@ -53,370 +82,5533 @@ enum class notifly_result
     observer_not_found =        -1,
     notification_not_found =    -2,
     payload_type_not_match =    -3,
-    no_more_observer_ids =      -4
+    no_more_observer_ids =      -4,
+    invalid_group =             -5,
+    invalid_dependency =        -6,
+    invalid_domain =            -7,
+    bulkhead_not_found =        -8,
+    ring_full =                 -9,
+    realtime_disabled =        -10
+};
+
+/**
+ * @brief   This enum class defines how the asynchronous deliveries of a notification center are ordered.
+ */
+enum class async_ordering
+{
+    // Deliveries run as soon as a worker is free, in no particular order.
+    none,
+    // Deliveries of the same notification run one at a time, in posting order, while deliveries of different
+    // notifications still run in parallel.
+    per_notification
 };
 
+/**
+ * @brief   This enum class defines where the observers of a post are run.
+ */
+enum class dispatch_mode
+{
+    // Every observer runs on the caller thread.
+    sync,
+    // Every observer runs on the thread pool.
+    async,
+    // Each observer runs on the caller thread while it is cheap, and on the thread pool once it becomes expensive,
+    // see adaptive_dispatch_config.
+    adaptive,
+    // The observers are split in chunks run in parallel by the caller thread and the thread pool, and the post
+    // returns once all of them have run, see parallel_dispatch_config.
+    parallel,
+    // Every observer runs on the shard the notification hashes to: a thread of its own, pinned to a core, that runs
+    // the deliveries of its notifications one at a time in posting order, see sharded_dispatch_config.
+    sharded
+};
 
+/**
+ * @brief   This struct holds the settings of dispatch_mode::sharded.
+ */
+struct sharded_dispatch_config
+{
+    // The number of shards. Zero uses one shard per hardware thread.
+    size_t shards = 0;
+    // Whether each shard thread is pinned to a core, shard i to core i modulo the number of cores.
+    bool pin_threads = true;
+};
 
 /**
- * @brief   This class is an observer that is used to observe notifications.
+ * @brief   This struct holds the settings of dispatch_mode::parallel.
  */
-class notification_observer
+struct parallel_dispatch_config
+{
+    // Notifications with fewer observers than this are notified serially on the caller thread.
+    size_t serial_below = 64;
+    // The number of observers in a chunk.
+    size_t chunk_size = 16;
+    // The largest number of pool workers helping the caller thread.
+    size_t max_helpers = 8;
+};
+
+/**
+ * @brief   This struct holds the thresholds of dispatch_mode::adaptive. The cost of each observer is a moving
+ *          average of how long its callback runs. An observer run inline is offloaded to the thread pool once its
+ *          cost rises above 'offload_above', and only comes back inline once it falls below 'inline_below', so that
+ *          an observer whose cost hovers around a single threshold does not flap.
+ */
+struct adaptive_dispatch_config
+{
+    // The cost above which an observer run inline is offloaded.
+    std::chrono::nanoseconds offload_above = std::chrono::microseconds(50);
+    // The cost below which an offloaded observer is run inline again.
+    std::chrono::nanoseconds inline_below = std::chrono::microseconds(20);
+};
+
+/**
+ * @brief   This struct holds the decisions dispatch_mode::adaptive made for an observer.
+ */
+struct adaptive_dispatch_stats
+{
+    // The moving average of how long the callback runs.
+    std::chrono::nanoseconds cost{0};
+    // Whether the observer is currently offloaded to the thread pool.
+    bool offloaded = false;
+    // The number of deliveries run inline.
+    uint64_t inline_deliveries = 0;
+    // The number of deliveries offloaded to the thread pool.
+    uint64_t offloaded_deliveries = 0;
+    // The number of times the observer moved between inline and offloaded.
+    uint64_t switches = 0;
+};
+
+/**
+ * @brief   This struct holds the settings of the load shedding of asynchronous deliveries. The shedder watches how
+ *          long deliveries wait before they start. Once even the shortest wait over a whole 'interval' stays above
+ *          'target', a standing queue has formed: the shedder starts dropping deliveries of sheddable notifications,
+ *          more and more often while the queue persists, and stops as soon as a delivery waits less than 'target'.
+ *          Short bursts thus get through, while sustained overload cannot build a long queue.
+ */
+struct load_shedding_config
+{
+    // The wait a delivery may tolerate before it starts.
+    std::chrono::nanoseconds target = std::chrono::milliseconds(5);
+    // The time the wait must stay above the target before deliveries are dropped, and the initial time between drops.
+    std::chrono::nanoseconds interval = std::chrono::milliseconds(100);
+};
+
+/**
+ * @brief   This struct holds what the load shedding of a notification center did.
+ */
+struct load_shedding_stats
+{
+    // The number of deliveries dropped.
+    uint64_t shed = 0;
+    // Whether deliveries are currently being dropped.
+    bool dropping = false;
+    // How long the last delivery started waited.
+    std::chrono::nanoseconds last_sojourn{0};
+};
+
+/**
+ * @brief   This enum class defines what a notification center does when an observer throws while being notified.
+ *          In every case the remaining observers are still notified and the failure is counted, see
+ *          notifly::get_failure_count().
+ */
+enum class exception_policy
+{
+    // The first exception thrown during a synchronous post is rethrown to the poster once every observer has been
+    // notified. Asynchronous deliveries have no poster to rethrow to, so their exceptions are captured instead.
+    propagate,
+    // Exceptions are kept by the center until notifly::take_exceptions() is called, and observers that threw are not
+    // counted in the value returned by notifly::post_notification().
+    capture,
+    // Exceptions are passed to the hook set with notifly::set_exception_hook(), and observers that threw are not
+    // counted in the value returned by notifly::post_notification().
+    report
+};
+
+/**
+ * @brief   The type of the hook receiving the exceptions thrown by observers under exception_policy::report. It is
+ *          called with the observer id, the notification and the exception, possibly from a worker thread.
+ */
+typedef std::function<void(int, int, std::exception_ptr)> exception_hook_t;
+
+/**
+ * @brief   This enum class defines the states of the circuit breaker of an observer.
+ */
+enum class breaker_state : uint8_t
+{
+    // The observer is notified normally.
+    closed,
+    // The observer failed too often, or was too slow, and is skipped.
+    open,
+    // The observer was open long enough, and a single probe delivery decides whether it closes or opens again.
+    half_open
+};
+
+/**
+ * @brief   The type of the hook receiving the transitions of circuit breakers. It is called with the observer id, the
+ *          previous state and the new state, possibly from a worker thread.
+ */
+typedef std::function<void(int, breaker_state, breaker_state)> breaker_hook_t;
+
+/**
+ * @brief   This struct holds the thresholds of a circuit breaker.
+ */
+struct circuit_breaker_config
+{
+    // The number of deliveries evaluated together. The breaker can only trip once a window is complete.
+    uint32_t window = 20;
+    // The fraction of the deliveries of a window that must throw for the breaker to trip.
+    double failure_rate = 0.5;
+    // The duration over which a delivery is slow. Zero disables latency tracking.
+    std::chrono::nanoseconds slow_call_duration{0};
+    // The fraction of the deliveries of a window that must be slow for the breaker to trip.
+    double slow_call_rate = 0.5;
+    // How long the breaker stays open before letting a probe delivery through.
+    std::chrono::nanoseconds open_duration = std::chrono::seconds(1);
+};
+
+/**
+ * @brief   This class is the circuit breaker of an observer. While closed, deliveries are counted over tumbling
+ *          windows and the breaker trips when too many of a window threw or were slow. While open, the observer is
+ *          skipped at the cost of a single atomic load until the open duration elapses; then a single probe delivery
+ *          goes through, closing the breaker if it succeeds and opening it again otherwise.
+ */
+class circuit_breaker
 {
 public:
+    // 'clock_t' is the clock used to measure deliveries and open durations.
+    typedef std::chrono::steady_clock clock_t;
+
     /**
-     * @brief   Constructor. This constructor initializes the observer with a unique identifier.
+     * @brief   This enum class defines the answers of the breaker to a delivery.
      */
-    explicit notification_observer(const int a_id, const int a_notification, std::string a_types) :
-            m_callback(nullptr),
-            m_id(a_id),
-            m_types(std::move(a_types)),
-            is_active(false),
-            m_notification(a_notification)
-    {}
+    enum class permit
+    {
+        denied,
+        granted,
+        probe
+    };
 
     /**
-     * @brief   Get the observer id.
+     * @brief   Constructor.
      */
-    int get_id() const
+    explicit circuit_breaker(const circuit_breaker_config& a_config) : m_config(a_config) {}
+
+    /**
+     * @brief                   This method tells whether a delivery may go through.
+     * @param a_on_transition   Called with the previous and the new state if the breaker changes state.
+     * @return                  Whether the delivery is denied, granted, or granted as the probe of a half open breaker.
+     */
+    template<typename Listener>
+    permit allow(Listener&& a_on_transition)
     {
-        return m_id;
+        auto state = m_state.load(std::memory_order_acquire);
+        if(state == breaker_state::closed) return permit::granted;
+        if(state == breaker_state::half_open) return permit::denied;
+
+        // The breaker is open: a probe goes through once the open duration has elapsed, and only one.
+        if(clock_t::now().time_since_epoch().count() - m_opened_at.load(std::memory_order_relaxed) <
+           std::chrono::duration_cast<clock_t::duration>(m_config.open_duration).count())
+        {
+            return permit::denied;
+        }
+        if(!m_state.compare_exchange_strong(state, breaker_state::half_open)) return permit::denied;
+
+        a_on_transition(breaker_state::open, breaker_state::half_open);
+        return permit::probe;
     }
 
     /**
-     * @brief   Get the types of the arguments for the callback function.
+     * @brief                   This method records the outcome of a delivery that was let through.
+     * @param a_permit          The permit the delivery was given.
+     * @param a_failed          Whether the delivery threw.
+     * @param a_latency         How long the delivery took.
+     * @param a_on_transition   Called with the previous and the new state if the breaker changes state.
      */
-    std::string get_types() const
+    template<typename Listener>
+    void record(const permit a_permit, const bool a_failed, const clock_t::duration a_latency,
+                Listener&& a_on_transition)
     {
-        return m_types;
+        const bool slow = m_config.slow_call_duration.count() > 0 && a_latency > m_config.slow_call_duration;
+
+        if(a_permit == permit::probe)
+        {
+            if(a_failed || slow)
+            {
+                trip(breaker_state::half_open, a_on_transition);
+            }
+            else
+            {
+                m_state.store(breaker_state::closed, std::memory_order_release);
+                a_on_transition(breaker_state::half_open, breaker_state::closed);
+            }
+            return;
+        }
+
+        std::unique_lock lock(m_mutex);
+
+        // Deliveries let through before the breaker tripped say nothing about the current window.
+        if(m_state.load(std::memory_order_relaxed) != breaker_state::closed) return;
+
+        ++m_calls;
+        m_failures += a_failed;
+        m_slow_calls += slow;
+        if(m_calls < m_config.window) return;
+
+        const auto calls = static_cast<double>(m_calls);
+        const bool trips = m_failures / calls >= m_config.failure_rate ||
+                           (m_config.slow_call_duration.count() > 0 && m_slow_calls / calls >= m_config.slow_call_rate);
+        m_calls = m_failures = m_slow_calls = 0;
+        if(!trips) return;
+
+        lock.unlock();
+        trip(breaker_state::closed, a_on_transition);
+    }
+
+    /**
+     * @brief   This method tells whether allow() would let a delivery through, without changing the state of the
+     *          breaker.
+     */
+    bool may_allow() const
+    {
+        const auto state = m_state.load(std::memory_order_acquire);
+        if(state != breaker_state::open) return state == breaker_state::closed;
+        return clock_t::now().time_since_epoch().count() - m_opened_at.load(std::memory_order_relaxed) >=
+               std::chrono::duration_cast<clock_t::duration>(m_config.open_duration).count();
     }
 
-    // 'm_callback' is a member variable that holds the callback function to be invoked when a notification is posted.
-    // The callback function takes a std::any parameter and returns a std::any value.
-    std::function<std::any(std::any)> m_callback;
+    /**
+     * @brief   Get the state of the breaker.
+     */
+    breaker_state get_state() const
+    {
+        return m_state.load(std::memory_order_acquire);
+    }
 
 private:
-    // 'm_id' is a member variable that holds the unique identifier for the observer.
-    int m_id;
+    /**
+     * @brief                   This method opens the breaker.
+     * @param a_from            The state the breaker is in.
+     * @param a_on_transition   Called with the previous and the new state.
+     */
+    template<typename Listener>
+    void trip(breaker_state a_from, Listener&& a_on_transition)
+    {
+        m_opened_at.store(clock_t::now().time_since_epoch().count(), std::memory_order_relaxed);
+        if(!m_state.compare_exchange_strong(a_from, breaker_state::open, std::memory_order_acq_rel)) return;
+        a_on_transition(a_from, breaker_state::open);
+    }
 
-    // 'm_types' is a member variable that holds the types of the arguments for the callback function.
-    std::string m_types;
+    // 'm_config' is a member variable that holds the thresholds of the breaker.
+    const circuit_breaker_config m_config;
+    // 'm_state' is a member variable that holds the state of the breaker.
+    std::atomic<breaker_state> m_state{breaker_state::closed};
+    // 'm_opened_at' is a member variable that holds when the breaker last opened, in ticks of 'clock_t'.
+    std::atomic<clock_t::rep> m_opened_at{0};
+    // 'm_mutex' is a member variable that holds a mutex protecting the counters of the current window.
+    std::mutex m_mutex;
+    // 'm_calls' is a member variable that holds the number of deliveries of the current window.
+    uint32_t m_calls = 0;
+    // 'm_failures' is a member variable that holds the number of deliveries of the current window that threw.
+    uint32_t m_failures = 0;
+    // 'm_slow_calls' is a member variable that holds the number of deliveries of the current window that were slow.
+    uint32_t m_slow_calls = 0;
+};
 
-    // 'is_active' is a member variable that holds a flag to indicate whether the observer is active.
-    bool is_active;
+/**
+ * @brief   The number of observer groups supported by a notification center. Groups are tracked as bits of a single
+ *          atomic mask, so a group is an integer in the range [0, max_observer_groups).
+ */
+constexpr int max_observer_groups = 64;
 
-    // 'm_notification' is a member variable that holds the name of the notification that the observer is observing.
-    int m_notification;
+/**
+ * @brief               This function pins a thread to a set of cores.
+ * @param a_thread      The thread.
+ * @param a_cpus        The cores the thread may run on.
+ * @return              True if the thread was pinned, false if it could not be or if the platform does not support it.
+ */
+inline bool pin_thread(std::thread& a_thread, const std::span<const unsigned> a_cpus)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(const auto cpu : a_cpus)
+    {
+        if(cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(a_thread.native_handle(), sizeof(set), &set) == 0;
+#else
+    (void)a_thread;
+    (void)a_cpus;
+    return false;
+#endif
+}
+
+/**
+ * @brief               This function pins a thread to a core.
+ * @param a_thread      The thread.
+ * @param a_cpu         The core.
+ * @return              True if the thread was pinned, false if it could not be or if the platform does not support it.
+ */
+inline bool pin_thread(std::thread& a_thread, const unsigned a_cpu)
+{
+    return pin_thread(a_thread, std::span<const unsigned>(&a_cpu, 1));
+}
+
+/**
+ * @brief   This class describes the CPUs of the machine: for each logical CPU, its socket, its physical core and its
+ *          last level cache domain, i.e. the CPUs sharing its largest cache. On Linux it is read from
+ *          /sys/devices/system/cpu; elsewhere, or if that fails, every CPU is assumed to be a core of its own on a
+ *          single socket sharing a single cache.
+ */
+class cpu_topology
+{
+public:
+    /**
+     * @brief   This struct holds the description of a logical CPU.
+     */
+    struct cpu
+    {
+        // The id of the CPU, as used to pin threads.
+        unsigned id;
+        // The socket of the CPU.
+        int package;
+        // The physical core of the CPU, unique within its socket.
+        int core;
+        // The index of the last level cache domain of the CPU in domains().
+        size_t domain;
+    };
+
+    /**
+     * @brief   Read the topology of the machine.
+     */
+    static cpu_topology detect()
+    {
+        cpu_topology topology;
+        const std::string root = "/sys/devices/system/cpu/";
+
+        auto online = parse_list(read_line(root + "online"));
+        if(online.empty())
+        {
+            for(unsigned id = 0; id < std::max(std::thread::hardware_concurrency(), 1u); ++id)
+            {
+                online.push_back(id);
+            }
+        }
+
+        // Each domain is keyed by the smallest CPU sharing the last level cache.
+        std::map<unsigned, size_t> domains;
+        for(const auto id : online)
+        {
+            const auto path = root + "cpu" + std::to_string(id) + "/";
+            const auto package = read_int(path + "topology/physical_package_id", 0);
+            const auto core = read_int(path + "topology/core_id", static_cast<int>(id));
+
+            auto shared = id;
+            int level = 0;
+            for(int index = 0; ; ++index)
+            {
+                const auto cache = path + "cache/index" + std::to_string(index) + "/";
+                const auto cache_level = read_int(cache + "level", -1);
+                if(cache_level < 0) break;
+                if(cache_level < level) continue;
+
+                const auto cpus = parse_list(read_line(cache + "shared_cpu_list"));
+                if(cpus.empty()) continue;
+                level = cache_level;
+                shared = *std::ranges::min_element(cpus);
+            }
+
+            const auto [domain, inserted] = domains.try_emplace(shared, topology.m_domains.size());
+            if(inserted) topology.m_domains.emplace_back();
+            topology.m_domains[domain->second].push_back(id);
+            topology.m_cpus.push_back({id, package, core, domain->second});
+        }
+        return topology;
+    }
+
+    /**
+     * @brief   Get the logical CPUs.
+     */
+    const std::vector<cpu>& cpus() const
+    {
+        return m_cpus;
+    }
+
+    /**
+     * @brief   Get the last level cache domains, each as the list of its CPUs.
+     */
+    const std::vector<std::vector<unsigned>>& domains() const
+    {
+        return m_domains;
+    }
+
+private:
+    /**
+     * @brief   Read the first line of a file, or an empty string if it cannot be read.
+     */
+    static std::string read_line(const std::string& a_path)
+    {
+        std::ifstream file(a_path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    /**
+     * @brief   Read an integer from a file, or return 'a_default' if it cannot be read.
+     */
+    static int read_int(const std::string& a_path, const int a_default)
+    {
+        std::ifstream file(a_path);
+        int value;
+        return file >> value ? value : a_default;
+    }
+
+    /**
+     * @brief   Parse a list of CPUs such as "0-3,8,10-11".
+     */
+    static std::vector<unsigned> parse_list(const std::string& a_list)
+    {
+        std::vector<unsigned> cpus;
+        std::istringstream stream(a_list);
+        std::string range;
+        while(std::getline(stream, range, ','))
+        {
+            unsigned first = 0;
+            unsigned last = 0;
+            const auto dash = range.find('-');
+            try
+            {
+                first = static_cast<unsigned>(std::stoul(range.substr(0, dash)));
+                last = dash == std::string::npos ? first : static_cast<unsigned>(std::stoul(range.substr(dash + 1)));
+            }
+            catch(const std::exception&)
+            {
+                continue;
+            }
+            for(auto id = first; id <= last; ++id)
+            {
+                cpus.push_back(id);
+            }
+        }
+        return cpus;
+    }
+
+    // 'm_cpus' is a member variable that holds the logical CPUs.
+    std::vector<cpu> m_cpus;
+    // 'm_domains' is a member variable that holds the CPUs of each last level cache domain.
+    std::vector<std::vector<unsigned>> m_domains;
+};
+
+/**
+ * @brief   This function tells the processor the caller is spinning, which saves power and frees the pipeline for a
+ *          sibling hyper-thread without giving up the core.
+ */
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/**
+ * @brief   This class is an unbounded multiple producer, single consumer queue. Producers push with a single atomic
+ *          exchange and never wait for each other or for the consumer; the consumer pops without any atomic
+ *          read-modify-write. A push that is still linking its node hides the nodes pushed after it for the few
+ *          instructions it takes, so the consumer may briefly see the queue as empty.
+ */
+template<typename T>
+class mpsc_queue
+{
+public:
+    /**
+     * @brief   Constructor.
+     */
+    mpsc_queue() : m_head(new node), m_tail(m_head.load(std::memory_order_relaxed))
+    {}
+
+    /**
+     * @brief   Destructor. It frees the values left in the queue.
+     */
+    ~mpsc_queue()
+    {
+        while(m_tail != nullptr)
+        {
+            auto* next = m_tail->m_next.load(std::memory_order_relaxed);
+            delete m_tail;
+            m_tail = next;
+        }
+    }
+
+    mpsc_queue(const mpsc_queue&) = delete;
+    mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+    /**
+     * @brief   Push a value. It may be called by any thread.
+     */
+    void push(T a_value)
+    {
+        auto* pushed = new node{std::move(a_value)};
+        auto* previous = m_head.exchange(pushed, std::memory_order_acq_rel);
+        previous->m_next.store(pushed, std::memory_order_release);
+    }
+
+    /**
+     * @brief   Pop a value. It may only be called by the consumer thread.
+     * @return  True if a value was popped into 'a_value'.
+     */
+    bool pop(T& a_value)
+    {
+        auto* next = m_tail->m_next.load(std::memory_order_acquire);
+        if(next == nullptr) return false;
+
+        // The popped node becomes the new stub, and the previous stub is freed.
+        a_value = std::move(next->m_value);
+        delete m_tail;
+        m_tail = next;
+        return true;
+    }
+
+    /**
+     * @brief   Check whether the queue looks empty. It may only be called by the consumer thread.
+     */
+    bool empty() const
+    {
+        return m_tail->m_next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    /**
+     * @brief   This struct holds a node of the queue.
+     */
+    struct node
+    {
+        // 'm_value' holds the value of the node.
+        T m_value{};
+        // 'm_next' holds the node pushed after this one.
+        std::atomic<node*> m_next{nullptr};
+    };
+
+    // 'm_head' is a member variable that holds the node pushed last, written by the producers.
+    alignas(64) std::atomic<node*> m_head;
+    // 'm_tail' is a member variable that holds the stub node preceding the next value, owned by the consumer.
+    alignas(64) node* m_tail;
 };
 
-class id_manager
-{
-public:
+/**
+ * @brief   This class is a bounded multiple producer, multiple consumer queue on a ring of slots. Each slot carries a
+ *          sequence number telling whether it is free for the producer of its turn or filled for the consumer of its
+ *          turn, so producers and consumers only contend on the position they claim with a compare-and-swap, and
+ *          slots sit on cache lines of their own so neighbours do not share them. Several values can be claimed and
+ *          moved with a single compare-and-swap.
+ */
+template<typename T>
+class mpmc_ring
+{
+public:
+    /**
+     * @brief               Constructor.
+     * @param a_capacity    The number of slots, rounded up to a power of two.
+     */
+    explicit mpmc_ring(const size_t a_capacity) :
+            m_mask(std::bit_ceil(std::max<size_t>(a_capacity, 2)) - 1),
+            m_slots(new slot[m_mask + 1])
+    {
+        for(size_t i = 0; i <= m_mask; ++i)
+        {
+            m_slots[i].m_sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpmc_ring(const mpmc_ring&) = delete;
+    mpmc_ring& operator=(const mpmc_ring&) = delete;
+
+    /**
+     * @brief   Push a value, unless the ring is full.
+     * @return  True if the value was pushed, false if the ring is full and 'a_value' was left untouched.
+     */
+    bool try_push(T& a_value)
+    {
+        return try_push_bulk(std::span<T>(&a_value, 1)) == 1;
+    }
+
+    /**
+     * @brief   Pop a value, unless the ring is empty.
+     * @return  True if a value was popped into 'a_value'.
+     */
+    bool try_pop(T& a_value)
+    {
+        return try_pop_bulk(std::span<T>(&a_value, 1)) == 1;
+    }
+
+    /**
+     * @brief           Push as many of the values as there are free slots, in order, with a single claim.
+     * @param a_values  The values. Those pushed are moved from.
+     * @return          The number of values pushed, from the front of 'a_values'.
+     */
+    size_t try_push_bulk(std::span<T> a_values)
+    {
+        auto position = m_enqueue_position.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            const auto count = claimable(position, a_values.size(), 0);
+            if(count == 0)
+            {
+                // Either the ring is full, or another producer claimed the position first.
+                const auto current = m_enqueue_position.load(std::memory_order_relaxed);
+                if(current == position) return 0;
+                position = current;
+                continue;
+            }
+            if(m_enqueue_position.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+            {
+                for(size_t i = 0; i < count; ++i)
+                {
+                    auto& claimed = m_slots[(position + i) & m_mask];
+                    claimed.m_value = std::move(a_values[i]);
+                    claimed.m_sequence.store(position + i + 1, std::memory_order_release);
+                }
+                return count;
+            }
+        }
+    }
+
+    /**
+     * @brief           Pop up to as many values as 'a_values' holds, in order, with a single claim.
+     * @param a_values  Where to store the values.
+     * @return          The number of values popped, to the front of 'a_values'.
+     */
+    size_t try_pop_bulk(std::span<T> a_values)
+    {
+        auto position = m_dequeue_position.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            const auto count = claimable(position, a_values.size(), 1);
+            if(count == 0)
+            {
+                const auto current = m_dequeue_position.load(std::memory_order_relaxed);
+                if(current == position) return 0;
+                position = current;
+                continue;
+            }
+            if(m_dequeue_position.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+            {
+                for(size_t i = 0; i < count; ++i)
+                {
+                    auto& claimed = m_slots[(position + i) & m_mask];
+                    a_values[i] = std::move(claimed.m_value);
+                    claimed.m_value = T{};
+                    claimed.m_sequence.store(position + i + m_mask + 1, std::memory_order_release);
+                }
+                return count;
+            }
+        }
+    }
+
+    /**
+     * @brief   Get the number of slots.
+     */
+    size_t capacity() const
+    {
+        return m_mask + 1;
+    }
+
+private:
+    /**
+     * @brief               Count the slots from a position on that are ready for the turn of the position: free
+     *                      for a producer, or filled for a consumer.
+     * @param a_position    The position.
+     * @param a_max         The most slots to count.
+     * @param a_offset      0 for a producer, 1 for a consumer.
+     * @return              The number of ready slots.
+     */
+    size_t claimable(const size_t a_position, const size_t a_max, const size_t a_offset) const
+    {
+        size_t count = 0;
+        while(count < a_max && count <= m_mask &&
+              m_slots[(a_position + count) & m_mask].m_sequence.load(std::memory_order_acquire) ==
+              a_position + count + a_offset)
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * @brief   This struct holds a slot of the ring, alone on its cache line.
+     */
+    struct alignas(64) slot
+    {
+        // 'm_sequence' holds the position the slot is ready for: equal to it when free, one past it when filled.
+        std::atomic<size_t> m_sequence;
+        // 'm_value' holds the value of the slot.
+        T m_value{};
+    };
+
+    // 'm_mask' is a member variable that holds the number of slots minus one, to wrap positions.
+    const size_t m_mask;
+    // 'm_slots' is a member variable that holds the slots.
+    std::unique_ptr<slot[]> m_slots;
+    // 'm_enqueue_position' is a member variable that holds the position of the next push.
+    alignas(64) std::atomic<size_t> m_enqueue_position{0};
+    // 'm_dequeue_position' is a member variable that holds the position of the next pop.
+    alignas(64) std::atomic<size_t> m_dequeue_position{0};
+};
+
+/**
+ * @brief   This class is a bounded single producer, single consumer queue on a ring of values. The producer only
+ *          writes the tail and the consumer only writes the head, so neither ever waits for the other nor needs a
+ *          compare-and-swap. Each keeps a cached copy of the index of the other on its own cache line, and only reads
+ *          the shared one when the cached copy says the ring is full, or empty.
+ */
+template<typename T>
+class spsc_ring
+{
+public:
+    /**
+     * @brief               Constructor.
+     * @param a_capacity    The number of values, rounded up to a power of two.
+     */
+    explicit spsc_ring(const size_t a_capacity) :
+            m_mask(std::bit_ceil(std::max<size_t>(a_capacity, 2)) - 1),
+            m_values(new T[m_mask + 1])
+    {}
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    /**
+     * @brief   Push a value, unless the ring is full. It may only be called by the producer.
+     * @return  True if the value was pushed, false if the ring is full and 'a_value' was left untouched.
+     */
+    bool try_push(T& a_value)
+    {
+        if(free_slots() == 0) return false;
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        m_values[tail & m_mask] = std::move(a_value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief   Pop a value, unless the ring is empty. It may only be called by the consumer.
+     * @return  True if a value was popped into 'a_value'.
+     */
+    bool try_pop(T& a_value)
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        if(head == m_cached_tail)
+        {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if(head == m_cached_tail) return false;
+        }
+        a_value = std::move(m_values[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief   Get the number of values that can be pushed. It may only be called by the producer.
+     */
+    size_t free_slots()
+    {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        if(tail - m_cached_head > m_mask) m_cached_head = m_head.load(std::memory_order_acquire);
+        return m_mask + 1 - (tail - m_cached_head);
+    }
+
+    /**
+     * @brief   Check whether the ring looks empty. It may be called by any thread.
+     */
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    // 'm_mask' is a member variable that holds the number of values minus one, to wrap indexes.
+    const size_t m_mask;
+    // 'm_values' is a member variable that holds the values.
+    std::unique_ptr<T[]> m_values;
+    // 'm_tail' is a member variable that holds the index of the next push, written by the producer.
+    alignas(64) std::atomic<size_t> m_tail{0};
+    // 'm_cached_head' is a member variable that holds the head as last read by the producer.
+    size_t m_cached_head = 0;
+    // 'm_head' is a member variable that holds the index of the next pop, written by the consumer.
+    alignas(64) std::atomic<size_t> m_head{0};
+    // 'm_cached_tail' is a member variable that holds the tail as last read by the consumer.
+    size_t m_cached_tail = 0;
+};
+
+/**
+ * @brief   This struct holds the settings of the queue of notifly::try_post().
+ */
+struct realtime_config
+{
+    // The number of posts the queue holds, rounded up to a power of two. The queue is allocated up front.
+    size_t capacity = 1024;
+    // How long the dispatcher thread sleeps once the queue is empty before looking at it again. Posting threads
+    // never wake it, which would take a system call, so this bounds the extra latency of their posts.
+    std::chrono::microseconds poll_interval{100};
+};
+
+/**
+ * @brief   This struct holds the metrics of the queue of notifly::try_post().
+ */
+struct realtime_stats
+{
+    // The number of posts queued.
+    uint64_t queued = 0;
+    // The number of posts refused because the queue was full.
+    uint64_t refused = 0;
+    // The number of queued posts the dispatcher thread could not make, e.g. because the payload did not match the
+    // observers of the notification, or whose observers threw under exception_policy::propagate.
+    uint64_t failed = 0;
+};
+
+/**
+ * @brief   This struct holds the settings of the busy-polling dispatcher.
+ */
+struct busy_poll_config
+{
+    // The core the dispatcher thread is pinned to, or -1 to leave it unpinned.
+    int cpu = -1;
+};
+
+/**
+ * @brief   This class runs tasks on a thread of its own that spins on a lock-free queue instead of sleeping, so a
+ *          pushed task starts within the time it takes the spinning core to see it, rather than after a thread wake-up.
+ *          The spinning core is the price: while disabled, the thread sleeps until enabled again, or given a task.
+ */
+class busy_poll_dispatcher
+{
+public:
+    /**
+     * @brief   Constructor. This constructor starts the dispatcher thread, disabled.
+     */
+    explicit busy_poll_dispatcher(const busy_poll_config& a_config) : m_thread([this]{ run(); })
+    {
+        if(a_config.cpu >= 0) pin_thread(m_thread, static_cast<unsigned>(a_config.cpu));
+    }
+
+    /**
+     * @brief   Destructor. The dispatcher runs the tasks left in its queue before being joined.
+     */
+    ~busy_poll_dispatcher()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop.store(true, std::memory_order_release);
+        }
+        m_wakeup.notify_one();
+        m_thread.join();
+    }
+
+    busy_poll_dispatcher(const busy_poll_dispatcher&) = delete;
+    busy_poll_dispatcher& operator=(const busy_poll_dispatcher&) = delete;
+
+    /**
+     * @brief   Make the dispatcher spin, or let it sleep once its queue is empty.
+     */
+    void set_enabled(const bool a_enabled)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_enabled.store(a_enabled, std::memory_order_seq_cst);
+        }
+        // A dispatcher that is disabled again before it woke up still runs the tasks pushed in the meantime.
+        m_wakeup.notify_one();
+    }
+
+    /**
+     * @brief   Push a task. Tasks pushed while the dispatcher is disabled, e.g. deliveries resumed after a notification
+     *          stopped using it, wake it up.
+     */
+    void push(std::function<void()> a_task)
+    {
+        m_tasks.push(std::move(a_task));
+
+        // Either the dispatcher sees the task before sleeping, or it is seen disabled here.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(m_enabled.load(std::memory_order_relaxed)) return;
+        {
+            std::lock_guard lock(m_mutex);
+        }
+        m_wakeup.notify_one();
+    }
+
+private:
+    /**
+     * @brief   Run the tasks of the queue, spinning while it is empty, until asked to stop.
+     */
+    void run()
+    {
+        std::function<void()> task;
+        for(;;)
+        {
+            if(m_tasks.pop(task))
+            {
+                task();
+                task = nullptr;
+                continue;
+            }
+            if(m_stop.load(std::memory_order_acquire)) return;
+            if(m_enabled.load(std::memory_order_acquire))
+            {
+                cpu_relax();
+                continue;
+            }
+
+            // Once disabled, no task is pushed anymore, but those pushed before must still run.
+            if(!m_tasks.empty()) continue;
+            std::unique_lock lock(m_mutex);
+            m_wakeup.wait(lock, [this]
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return m_enabled.load(std::memory_order_relaxed) || m_stop.load(std::memory_order_relaxed) ||
+                       !m_tasks.empty();
+            });
+        }
+    }
+
+    // 'm_tasks' is a member variable that holds the tasks waiting to run.
+    mpsc_queue<std::function<void()>> m_tasks;
+    // 'm_enabled' is a member variable that holds whether the dispatcher spins.
+    std::atomic<bool> m_enabled{false};
+    // 'm_stop' is a member variable that holds whether the dispatcher must stop.
+    std::atomic<bool> m_stop{false};
+    // 'm_mutex' is a member variable that holds a mutex used to sleep while disabled.
+    std::mutex m_mutex;
+    // 'm_wakeup' is a member variable that holds a condition variable signalled when the dispatcher is enabled or
+    // stopped.
+    std::condition_variable m_wakeup;
+    // 'm_thread' is a member variable that holds the thread of the dispatcher.
+    std::thread m_thread;
+};
+
+/**
+ * @brief   This enum class defines how an idle worker waits for the next task, trading latency for CPU.
+ */
+enum class wait_strategy
+{
+    // The worker spins on the queue, keeping its core busy: the lowest wake-up latency, at the cost of a full core.
+    spin,
+    // The worker spins for a while, then yields its core to other threads between checks of the queue.
+    spin_then_yield,
+    // The worker spins for a while, then sleeps until a task is pushed: no CPU while idle, but a wake-up to pay.
+    park
+};
+
+/**
+ * @brief   This enum class defines where the workers of a thread pool run, see cpu_topology.
+ */
+enum class affinity_policy
+{
+    // Workers are not pinned and run wherever the operating system schedules them.
+    none,
+    // Each worker is pinned to a core, filling a socket, and the cache domains within it, before the next.
+    compact,
+    // Each worker is pinned to a core, spreading the workers over the sockets and cache domains in turn.
+    scatter,
+    // Each worker is pinned to the set of cores of a last level cache domain, spreading the workers over them.
+    cache_domain
+};
+
+/**
+ * @brief   This struct holds the settings of the thread pool running the asynchronous deliveries of a notification
+ *          center.
+ */
+struct executor_config
+{
+    // The number of worker threads, the least the pool keeps when it is elastic.
+    size_t threads = 20;
+    // How idle workers wait for the next task.
+    wait_strategy wait = wait_strategy::park;
+    // How many times an idle worker checks the queue before yielding or sleeping.
+    uint32_t spin_iterations = 64;
+    // Where the workers run.
+    affinity_policy affinity = affinity_policy::none;
+    // The most worker threads of an elastic pool. When it is not above 'threads', the pool has a fixed size.
+    size_t max_threads = 0;
+    // How long a task may wait in the queue before an elastic pool starts another worker.
+    std::chrono::nanoseconds target_queue_delay = std::chrono::milliseconds(1);
+    // How long a worker of an elastic pool stays idle before it exits, as long as more than 'threads' are left.
+    std::chrono::nanoseconds idle_timeout = std::chrono::seconds(10);
+    // The number of slots of the lock-free queue of the pool, see mpmc_ring.
+    size_t queue_capacity = 1024;
+};
+
+/**
+ * @brief   This struct holds the metrics of a thread pool, and the sizing decisions of an elastic one.
+ */
+struct executor_stats
+{
+    // The number of workers.
+    uint64_t threads = 0;
+    // The largest number of workers the pool had.
+    uint64_t peak_threads = 0;
+    // The number of workers started because tasks waited longer than the target queue delay.
+    uint64_t grown = 0;
+    // The number of workers that exited after staying idle.
+    uint64_t shrunk = 0;
+    // The number of tasks waiting in the queues.
+    uint64_t queued = 0;
+    // An estimate of how long the oldest queued task has been waiting, as the lock-free queue cannot be looked into:
+    // the longer of the wait of the last task taken and the time since a task was last taken, or zero when no task
+    // is queued.
+    std::chrono::nanoseconds queue_delay{0};
+};
+
+/**
+ * @brief   This class is the thread pool running asynchronous deliveries. Idle workers wait for tasks following the
+ *          wait_strategy of the pool. Pushing a task only signals a worker if one is asleep, so a pool whose workers
+ *          spin never pays for a condition variable. When destroyed, the workers run the tasks left in the queue
+ *          before being joined.
+ *
+ *          Tasks go through a lock-free ring, see mpmc_ring, so that posting threads and workers never wait for each
+ *          other on a lock. Tasks pushed while the ring is full wait in an overflow queue behind a mutex instead of
+ *          being refused.
+ *
+ *          Workers are placed on the CPUs following the affinity_policy of the pool. Besides the shared queues, each
+ *          last level cache domain has a queue of its own: a task pushed to a domain is preferably run by a worker
+ *          of that domain, so that it finds the data it uses in a warm cache, but any idle worker takes it rather
+ *          than let it wait.
+ *
+ *          An elastic pool, one whose 'max_threads' is above its 'threads', has a supervisor thread checking how
+ *          long the oldest queued task has waited once per target queue delay. Past the target, all the workers are
+ *          busy, typically blocked in callbacks, and the supervisor starts one more, up to 'max_threads'. A worker
+ *          idle for 'idle_timeout' exits, down to 'threads'.
+ */
+class worker_pool
+{
+public:
+    /**
+     * @brief   Constructor. This constructor starts the workers and places them.
+     */
+    explicit worker_pool(const executor_config& a_config, const cpu_topology& a_topology = machine_topology()) :
+            m_wait(a_config.wait),
+            m_spin_iterations(a_config.spin_iterations),
+            m_min_threads(std::max<size_t>(a_config.threads, 1)),
+            m_max_threads(std::max(m_min_threads, a_config.max_threads)),
+            m_target_queue_delay(std::max<std::chrono::nanoseconds>(a_config.target_queue_delay,
+                                                                     std::chrono::microseconds(100))),
+            m_idle_timeout(a_config.idle_timeout),
+            m_placement(place(a_config.affinity, a_topology, m_max_threads)),
+            m_ring(a_config.queue_capacity),
+            m_domain_tasks(a_topology.domains().size())
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            for(size_t i = 0; i < m_min_threads; ++i)
+            {
+                spawn();
+            }
+        }
+        if(is_elastic()) m_supervisor = std::thread([this]{ supervise(); });
+    }
+
+    /**
+     * @brief   Destructor.
+     */
+    ~worker_pool()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop.store(true, std::memory_order_release);
+        }
+        m_wakeup.notify_all();
+        m_supervisor_wakeup.notify_all();
+        if(m_supervisor.joinable()) m_supervisor.join();
+
+        // Once stopping, workers no longer exit early, so the lists are not touched anymore.
+        for(auto& thread : m_threads)
+        {
+            thread.join();
+        }
+        for(auto& thread : m_retired)
+        {
+            thread.join();
+        }
+    }
+
+    worker_pool(const worker_pool&) = delete;
+    worker_pool& operator=(const worker_pool&) = delete;
+
+    /**
+     * @brief           This method pushes a task to the pool.
+     * @param a_task    The task.
+     * @param a_domain  The last level cache domain the task should run in, or -1 for any.
+     */
+    void push(std::function<void()> a_task, const int a_domain = -1)
+    {
+        queued_task task{std::move(a_task), clock_t::now()};
+        announce(1, task.m_enqueued);
+        if(a_domain >= 0 && static_cast<size_t>(a_domain) < m_domain_tasks.size())
+        {
+            std::lock_guard lock(m_mutex);
+            m_domain_tasks[a_domain].push(std::move(task));
+            m_locked.fetch_add(1, std::memory_order_release);
+        }
+        else if(!m_ring.try_push(task))
+        {
+            std::lock_guard lock(m_mutex);
+            m_overflow.push(std::move(task));
+            m_locked.fetch_add(1, std::memory_order_release);
+        }
+        wake(1);
+    }
+
+    /**
+     * @brief           This method pushes several tasks to the pool, claiming their slots in the ring at once.
+     * @param a_tasks   The tasks.
+     */
+    void push_bulk(std::vector<std::function<void()>> a_tasks)
+    {
+        if(a_tasks.empty()) return;
+
+        const auto now = clock_t::now();
+        std::vector<queued_task> tasks;
+        tasks.reserve(a_tasks.size());
+        for(auto& task : a_tasks)
+        {
+            tasks.push_back({std::move(task), now});
+        }
+        announce(tasks.size(), now);
+
+        const auto pushed = m_ring.try_push_bulk(tasks);
+        if(pushed < tasks.size())
+        {
+            std::lock_guard lock(m_mutex);
+            for(auto i = pushed; i < tasks.size(); ++i)
+            {
+                m_overflow.push(std::move(tasks[i]));
+            }
+            m_locked.fetch_add(tasks.size() - pushed, std::memory_order_release);
+        }
+        wake(tasks.size());
+    }
+
+    /**
+     * @brief   Get the number of workers.
+     */
+    size_t size() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_threads.size();
+    }
+
+    /**
+     * @brief   Get whether the number of workers follows the load.
+     */
+    bool is_elastic() const
+    {
+        return m_max_threads > m_min_threads;
+    }
+
+    /**
+     * @brief   Get the metrics of the pool.
+     */
+    executor_stats get_stats() const
+    {
+        std::lock_guard lock(m_mutex);
+        executor_stats stats;
+        stats.threads = m_threads.size();
+        stats.peak_threads = m_peak_threads;
+        stats.grown = m_grown;
+        stats.shrunk = m_shrunk;
+        stats.queued = m_pending.load(std::memory_order_relaxed);
+        stats.queue_delay = queue_delay(clock_t::now());
+        return stats;
+    }
+
+    /**
+     * @brief   Get the topology of the machine, read once.
+     */
+    static const cpu_topology& machine_topology()
+    {
+        static const cpu_topology topology = cpu_topology::detect();
+        return topology;
+    }
+
+private:
+    // 'clock_t' is the clock used to measure how long tasks wait.
+    typedef std::chrono::steady_clock clock_t;
+    // 'placement_t' is where a worker runs: its cache domain, or -1, and the CPUs it is pinned to, if any.
+    typedef std::pair<int, std::vector<unsigned>> placement_t;
+    // 'worker_t' is the position of a worker in the list of workers, used by the worker to remove itself.
+    typedef std::list<std::thread>::iterator worker_t;
+
+    /**
+     * @brief   This struct holds a task waiting in a queue, with the time it was pushed.
+     */
+    struct queued_task
+    {
+        // 'm_task' is a member variable that holds the task.
+        std::function<void()> m_task;
+        // 'm_enqueued' is a member variable that holds when the task was pushed.
+        clock_t::time_point m_enqueued;
+    };
+
+    /**
+     * @brief               This method places the workers following an affinity policy.
+     * @param a_policy      The policy.
+     * @param a_topology    The topology of the machine.
+     * @param a_threads     The number of workers.
+     * @return              The placement of each worker.
+     */
+    static std::vector<placement_t> place(const affinity_policy a_policy, const cpu_topology& a_topology,
+                                          const size_t a_threads)
+    {
+        std::vector<placement_t> placement(a_threads, placement_t{-1, {}});
+        const auto& cpus = a_topology.cpus();
+        if(a_policy == affinity_policy::none || cpus.empty()) return placement;
+
+        // The domains in the order they are filled by scatter and cache_domain: one per socket in turn.
+        std::vector<size_t> domains(a_topology.domains().size());
+        std::vector<size_t> rank(domains.size());
+        {
+            std::map<int, size_t> per_package;
+            for(size_t domain = 0; domain < domains.size(); ++domain)
+            {
+                const auto first = a_topology.domains()[domain].front();
+                const auto& info = *std::ranges::find(cpus, first, &cpu_topology::cpu::id);
+                rank[domain] = per_package[info.package]++;
+                domains[domain] = domain;
+            }
+            std::ranges::stable_sort(domains, {}, [&rank](const size_t a_domain){ return rank[a_domain]; });
+        }
+
+        if(a_policy == affinity_policy::cache_domain)
+        {
+            for(size_t i = 0; i < a_threads; ++i)
+            {
+                const auto domain = domains[i % domains.size()];
+                placement[i] = {static_cast<int>(domain), a_topology.domains()[domain]};
+            }
+            return placement;
+        }
+
+        // compact fills socket after socket, and domain after domain; scatter takes a CPU from each domain in turn.
+        // Both use the first hardware thread of the physical cores before their siblings.
+        auto order = cpus;
+        std::map<std::pair<int, int>, size_t> siblings;
+        std::vector<size_t> sibling_rank;
+        for(const auto& info : order)
+        {
+            sibling_rank.push_back(siblings[{info.package, info.core}]++);
+        }
+        std::vector<size_t> indexes(order.size());
+        for(size_t i = 0; i < indexes.size(); ++i)
+        {
+            indexes[i] = i;
+        }
+        if(a_policy == affinity_policy::compact)
+        {
+            std::ranges::stable_sort(indexes, {}, [&](const size_t a_index)
+            {
+                const auto& info = order[a_index];
+                return std::make_tuple(info.package, info.domain, sibling_rank[a_index], info.core);
+            });
+        }
+        else
+        {
+            std::vector<size_t> position(order.size());
+            std::map<std::pair<size_t, size_t>, size_t> taken;
+            for(size_t i = 0; i < order.size(); ++i)
+            {
+                position[i] = taken[{sibling_rank[i], order[i].domain}]++;
+            }
+            std::ranges::stable_sort(indexes, {}, [&](const size_t a_index)
+            {
+                const auto domain = std::ranges::find(domains, order[a_index].domain) - domains.begin();
+                return std::make_tuple(sibling_rank[a_index], position[a_index], domain);
+            });
+        }
+
+        for(size_t i = 0; i < a_threads; ++i)
+        {
+            const auto& info = order[indexes[i % indexes.size()]];
+            placement[i] = {static_cast<int>(info.domain), {info.id}};
+        }
+        return placement;
+    }
+
+    /**
+     * @brief   Start a worker and place it. It must be called with 'm_mutex' held.
+     */
+    void spawn()
+    {
+        const auto& [domain, cpus] = m_placement[m_threads.size() % m_placement.size()];
+        const auto worker = m_threads.emplace(m_threads.end());
+        // The worker only uses its position to exit, which takes the lock held here.
+        *worker = std::thread([this, domain, worker]{ run(domain, worker); });
+        if(!cpus.empty()) pin_thread(*worker, cpus);
+        m_peak_threads = std::max<uint64_t>(m_peak_threads, m_threads.size());
+    }
+
+    /**
+     * @brief   Check the queue delay once per target, starting a worker when it is over the target, and join the
+     *          workers that exited.
+     */
+    void supervise()
+    {
+        std::unique_lock lock(m_mutex);
+        while(!m_stop.load(std::memory_order_relaxed))
+        {
+            m_supervisor_wakeup.wait_for(lock, m_target_queue_delay, [this]
+            {
+                return m_stop.load(std::memory_order_relaxed);
+            });
+            if(m_stop.load(std::memory_order_relaxed)) return;
+
+            if(m_threads.size() < m_max_threads && queue_delay(clock_t::now()) > m_target_queue_delay)
+            {
+                spawn();
+                ++m_grown;
+            }
+
+            auto retired = std::move(m_retired);
+            m_retired.clear();
+            lock.unlock();
+            for(auto& thread : retired)
+            {
+                thread.join();
+            }
+            lock.lock();
+        }
+    }
+
+    /**
+     * @brief           Count tasks about to be queued, so that the workers look for them.
+     * @param a_count   The number of tasks.
+     * @param a_now     When the tasks were pushed.
+     */
+    void announce(const size_t a_count, const clock_t::time_point a_now)
+    {
+        // A queue becoming busy starts the clock of the queue delay.
+        if(m_pending.fetch_add(a_count) == 0) m_last_taken.store(a_now.time_since_epoch().count());
+    }
+
+    /**
+     * @brief           Wake sleeping workers for tasks just queued.
+     * @param a_count   The number of tasks.
+     */
+    void wake(const size_t a_count)
+    {
+        // A worker going to sleep registers itself before checking 'm_pending' under the lock: either it sees the
+        // tasks, or it is seen here, and taking the lock makes sure it is waiting before it is notified.
+        if(m_sleeping.load() == 0) return;
+        {
+            std::lock_guard lock(m_mutex);
+        }
+        if(a_count == 1) m_wakeup.notify_one();
+        else m_wakeup.notify_all();
+    }
+
+    /**
+     * @brief           Get how long the oldest queued task has waited, as far as can be told without looking into the
+     *                  ring: the longer of the wait of the last task taken, and the time since a task was last taken.
+     * @param a_now     The current time.
+     */
+    std::chrono::nanoseconds queue_delay(const clock_t::time_point a_now) const
+    {
+        if(m_pending.load(std::memory_order_relaxed) == 0) return std::chrono::nanoseconds(0);
+        const clock_t::time_point taken(clock_t::duration(m_last_taken.load(std::memory_order_relaxed)));
+        const std::chrono::nanoseconds waited(m_last_wait.load(std::memory_order_relaxed));
+        return std::max<std::chrono::nanoseconds>(a_now - taken, waited);
+    }
+
+    /**
+     * @brief           Run tasks until the pool is destroyed and its queues are empty, or the worker has been idle
+     *                  long enough to exit.
+     * @param a_domain  The cache domain of the worker, or -1.
+     * @param a_worker  The position of the worker in the list of workers.
+     */
+    void run(const int a_domain, const worker_t a_worker)
+    {
+        queued_task task;
+        for(;;)
+        {
+            if(!wait_for_task(a_worker)) return;
+
+            if(!take(a_domain, task))
+            {
+                // A task being pushed is counted before it can be taken, so the worker simply looks again.
+                if(m_stop.load(std::memory_order_relaxed) && m_pending.load() == 0) return;
+                continue;
+            }
+            m_pending.fetch_sub(1, std::memory_order_relaxed);
+
+            const auto now = clock_t::now();
+            m_last_taken.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+            m_last_wait.store(std::chrono::nanoseconds(now - task.m_enqueued).count(), std::memory_order_relaxed);
+            task.m_task();
+            task.m_task = nullptr;
+        }
+    }
+
+    /**
+     * @brief           Take the next task of a worker: from its own domain first, then from the ring, then from the
+     *                  overflow queue or any other domain. The locked queues are only looked at when they hold tasks.
+     * @param a_domain  The cache domain of the worker, or -1.
+     * @param a_task    Where to store the task.
+     * @return          True if a task was taken.
+     */
+    bool take(const int a_domain, queued_task& a_task)
+    {
+        const auto pop = [this, &a_task](std::queue<queued_task>& a_queue)
+        {
+            if(a_queue.empty()) return false;
+            a_task = std::move(a_queue.front());
+            a_queue.pop();
+            m_locked.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        };
+
+        if(a_domain >= 0 && m_locked.load(std::memory_order_acquire) != 0)
+        {
+            std::lock_guard lock(m_mutex);
+            if(pop(m_domain_tasks[a_domain])) return true;
+        }
+        if(m_ring.try_pop(a_task)) return true;
+        if(m_locked.load(std::memory_order_acquire) == 0) return false;
+
+        std::lock_guard lock(m_mutex);
+        return pop(m_overflow) || std::ranges::any_of(m_domain_tasks, pop);
+    }
+
+    /**
+     * @brief           Let an idle worker of an elastic pool exit, if the pool has more workers than its minimum. It
+     *                  must be called with 'm_mutex' held.
+     * @param a_worker  The position of the worker in the list of workers.
+     * @return          True if the worker must exit.
+     */
+    bool retire(const worker_t a_worker)
+    {
+        if(m_stop.load(std::memory_order_relaxed) || m_pending.load(std::memory_order_relaxed) != 0 ||
+           m_threads.size() <= m_min_threads)
+        {
+            return false;
+        }
+        // The supervisor joins the thread, as a thread cannot join itself.
+        m_retired.push_back(std::move(*a_worker));
+        m_threads.erase(a_worker);
+        ++m_shrunk;
+        return true;
+    }
+
+    /**
+     * @brief           Wait, following the wait strategy, until the queues may hold a task or the pool is stopping.
+     * @param a_worker  The position of the worker in the list of workers.
+     * @return          False if the worker stayed idle for the idle timeout and must exit.
+     */
+    bool wait_for_task(const worker_t a_worker)
+    {
+        const auto idle_until = clock_t::now() + m_idle_timeout;
+        uint32_t spins = 0;
+        while(m_pending.load(std::memory_order_acquire) == 0 && !m_stop.load(std::memory_order_acquire))
+        {
+            if(m_wait == wait_strategy::spin || spins < m_spin_iterations)
+            {
+                ++spins;
+                // Reading the clock between spins would slow them down, so it is only done once in a while.
+                if(is_elastic() && (spins & 0x3ff) == 0 && clock_t::now() >= idle_until)
+                {
+                    std::lock_guard lock(m_mutex);
+                    if(retire(a_worker)) return false;
+                }
+                cpu_relax();
+            }
+            else if(m_wait == wait_strategy::spin_then_yield)
+            {
+                if(is_elastic() && clock_t::now() >= idle_until)
+                {
+                    std::lock_guard lock(m_mutex);
+                    if(retire(a_worker)) return false;
+                }
+                std::this_thread::yield();
+            }
+            else
+            {
+                std::unique_lock lock(m_mutex);
+                const auto ready = [this]
+                {
+                    return m_pending.load() != 0 || m_stop.load(std::memory_order_relaxed);
+                };
+                m_sleeping.fetch_add(1);
+                bool retired = false;
+                if(!is_elastic())
+                {
+                    m_wakeup.wait(lock, ready);
+                }
+                else
+                {
+                    // Past the idle timeout, the worker exits unless the pool would fall below its minimum.
+                    auto deadline = idle_until;
+                    while(!m_wakeup.wait_until(lock, deadline, ready) && !(retired = retire(a_worker)))
+                    {
+                        deadline = clock_t::now() + m_idle_timeout;
+                    }
+                }
+                m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+                return !retired;
+            }
+        }
+        return true;
+    }
+
+    // 'm_wait' is a member variable that holds how idle workers wait.
+    const wait_strategy m_wait;
+    // 'm_spin_iterations' is a member variable that holds how many times an idle worker spins before yielding or
+    // sleeping.
+    const uint32_t m_spin_iterations;
+    // 'm_min_threads' is a member variable that holds the number of workers the pool starts with and keeps.
+    const size_t m_min_threads;
+    // 'm_max_threads' is a member variable that holds the most workers the pool grows to.
+    const size_t m_max_threads;
+    // 'm_target_queue_delay' is a member variable that holds how long a task may wait before a worker is started.
+    const std::chrono::nanoseconds m_target_queue_delay;
+    // 'm_idle_timeout' is a member variable that holds how long a worker stays idle before it exits.
+    const std::chrono::nanoseconds m_idle_timeout;
+    // 'm_placement' is a member variable that holds where each worker runs, by its rank among the workers.
+    const std::vector<placement_t> m_placement;
+    // 'm_mutex' is a member variable that holds a mutex protecting the queues and the workers.
+    mutable std::mutex m_mutex;
+    // 'm_wakeup' is a member variable that holds a condition variable signalled when a task is pushed while a worker
+    // sleeps.
+    std::condition_variable m_wakeup;
+    // 'm_ring' is a member variable that holds the tasks waiting to run on any worker.
+    mpmc_ring<queued_task> m_ring;
+    // 'm_overflow' is a member variable that holds the tasks pushed while the ring was full.
+    std::queue<queued_task> m_overflow;
+    // 'm_domain_tasks' is a member variable that holds the tasks waiting to run in each cache domain.
+    std::vector<std::queue<queued_task>> m_domain_tasks;
+    // 'm_pending' is a member variable that holds the number of tasks queued, polled by the spinning workers so they
+    // do not take the lock.
+    alignas(64) std::atomic<size_t> m_pending{0};
+    // 'm_locked' is a member variable that holds the number of tasks in the queues behind the mutex.
+    alignas(64) std::atomic<size_t> m_locked{0};
+    // 'm_last_taken' is a member variable that holds when a task was last taken, or the queues became busy.
+    std::atomic<clock_t::rep> m_last_taken{0};
+    // 'm_last_wait' is a member variable that holds how long, in nanoseconds, the last task taken waited.
+    std::atomic<int64_t> m_last_wait{0};
+    // 'm_sleeping' is a member variable that holds the number of workers asleep.
+    alignas(64) std::atomic<size_t> m_sleeping{0};
+    // 'm_stop' is a member variable that holds whether the pool is being destroyed.
+    std::atomic<bool> m_stop{false};
+    // 'm_peak_threads' is a member variable that holds the largest number of workers the pool had.
+    uint64_t m_peak_threads = 0;
+    // 'm_grown' is a member variable that holds the number of workers started by the supervisor.
+    uint64_t m_grown = 0;
+    // 'm_shrunk' is a member variable that holds the number of workers that exited after staying idle.
+    uint64_t m_shrunk = 0;
+    // 'm_threads' is a member variable that holds the workers.
+    std::list<std::thread> m_threads;
+    // 'm_retired' is a member variable that holds the workers that exited, waiting to be joined.
+    std::vector<std::thread> m_retired;
+    // 'm_supervisor_wakeup' is a member variable that holds a condition variable signalled when the pool stops.
+    std::condition_variable m_supervisor_wakeup;
+    // 'm_supervisor' is a member variable that holds the thread resizing an elastic pool.
+    std::thread m_supervisor;
+};
+
+/**
+ * @brief   This class runs tasks on a fixed set of shards, each a thread of its own with a mailbox only it consumes.
+ *          Tasks are routed to shards by key, so the tasks of a key always run on the same thread, one at a time in
+ *          pushing order, and whatever state they touch needs no locking. A shard takes its whole mailbox at once,
+ *          so the lock of a mailbox is taken once per batch by the shard rather than once per task.
+ */
+class shard_executor
+{
+public:
+    /**
+     * @brief   Constructor. This constructor starts the shard threads.
+     */
+    explicit shard_executor(const sharded_dispatch_config& a_config)
+    {
+        const auto cores = std::max(std::thread::hardware_concurrency(), 1u);
+        const auto shards = a_config.shards != 0 ? a_config.shards : cores;
+
+        m_shards.reserve(shards);
+        for(size_t i = 0; i < shards; ++i)
+        {
+            auto& current = *m_shards.emplace_back(std::make_unique<shard>());
+            current.m_thread = std::thread([&current]{ current.run(); });
+            if(a_config.pin_threads) pin_thread(current.m_thread, static_cast<unsigned>(i % cores));
+        }
+    }
+
+    /**
+     * @brief   Destructor. The shards run the tasks left in their mailbox before being joined.
+     */
+    ~shard_executor()
+    {
+        for(auto& current : m_shards)
+        {
+            {
+                std::lock_guard lock(current->m_mutex);
+                current->m_stop = true;
+            }
+            current->m_wakeup.notify_one();
+        }
+        for(auto& current : m_shards)
+        {
+            current->m_thread.join();
+        }
+    }
+
+    shard_executor(const shard_executor&) = delete;
+    shard_executor& operator=(const shard_executor&) = delete;
+
+    /**
+     * @brief           This method pushes a task to the mailbox of the shard a key hashes to.
+     * @param a_key     The key.
+     * @param a_task    The task.
+     */
+    void push(const int a_key, std::function<void()> a_task)
+    {
+        auto& current = *m_shards[std::hash<int>{}(a_key) % m_shards.size()];
+        bool was_empty;
+        {
+            std::lock_guard lock(current.m_mutex);
+            was_empty = current.m_mailbox.empty();
+            current.m_mailbox.push_back(std::move(a_task));
+        }
+        // A shard only sleeps on an empty mailbox, so only the first task of a batch needs to wake it.
+        if(was_empty) current.m_wakeup.notify_one();
+    }
+
+    /**
+     * @brief   Get the number of shards.
+     */
+    size_t size() const
+    {
+        return m_shards.size();
+    }
+
+private:
+    /**
+     * @brief   This struct holds a shard: its thread and its mailbox.
+     */
+    struct shard
+    {
+        // 'm_mutex' holds a mutex protecting the mailbox.
+        std::mutex m_mutex;
+        // 'm_wakeup' holds a condition variable signalled when the mailbox stops being empty.
+        std::condition_variable m_wakeup;
+        // 'm_mailbox' holds the tasks waiting to run.
+        std::vector<std::function<void()>> m_mailbox;
+        // 'm_stop' holds whether the shard must stop once its mailbox is empty.
+        bool m_stop = false;
+        // 'm_thread' holds the thread of the shard.
+        std::thread m_thread;
+
+        /**
+         * @brief   Run the tasks of the mailbox, a batch at a time, until asked to stop.
+         */
+        void run()
+        {
+            std::vector<std::function<void()>> batch;
+            for(;;)
+            {
+                {
+                    std::unique_lock lock(m_mutex);
+                    m_wakeup.wait(lock, [this]{ return m_stop || !m_mailbox.empty(); });
+                    if(m_mailbox.empty()) return;
+                    batch.swap(m_mailbox);
+                }
+                for(auto& task : batch)
+                {
+                    task();
+                }
+                batch.clear();
+            }
+        }
+    };
+
+    // 'm_shards' is a member variable that holds the shards.
+    std::vector<std::unique_ptr<shard>> m_shards;
+};
+
+/**
+ * @brief   This class sheds asynchronous deliveries following the controlled delay (CoDel) algorithm, see
+ *          load_shedding_config. Deliveries report how long they waited when they start, and are dropped there.
+ *          While dropping, the time between two drops is 'interval' divided by the square root of the number of
+ *          drops so far.
+ */
+class load_shedder
+{
+public:
+    // 'clock_t' is the clock used to measure the waits.
+    typedef std::chrono::steady_clock clock_t;
+
+    /**
+     * @brief   Constructor.
+     */
+    explicit load_shedder(const load_shedding_config& a_config) : m_config(a_config)
+    {}
+
+    /**
+     * @brief   Report the wait of a delivery about to start, and decide whether to drop it.
+     * @param   a_enqueued  When the delivery was queued.
+     * @param   a_sheddable Whether the delivery may be dropped. Other deliveries only report their wait.
+     * @return  Whether the delivery must be dropped.
+     */
+    bool shed(const clock_t::time_point a_enqueued, const bool a_sheddable)
+    {
+        const auto now = clock_t::now();
+        const auto sojourn = now - a_enqueued;
+
+        std::lock_guard lock(m_mutex);
+        m_last_sojourn = std::chrono::duration_cast<std::chrono::nanoseconds>(sojourn);
+
+        // The wait must have stayed above the target for a whole interval.
+        bool above = false;
+        if(sojourn < m_config.target)
+        {
+            m_first_above = {};
+        }
+        else if(m_first_above == clock_t::time_point{})
+        {
+            m_first_above = now + m_config.interval;
+        }
+        else
+        {
+            above = now >= m_first_above;
+        }
+
+        if(m_dropping)
+        {
+            if(!above)
+            {
+                m_dropping = false;
+                return false;
+            }
+            if(!a_sheddable || now < m_drop_next) return false;
+
+            ++m_count;
+            m_drop_next = next_drop(m_drop_next);
+            return drop();
+        }
+        if(!above || !a_sheddable) return false;
+
+        // A queue coming back soon after the last dropping state resumes near the drop rate it had reached.
+        m_dropping = true;
+        m_count = m_count > 2 && now - m_drop_next < 16 * m_config.interval ? m_count - 2 : 1;
+        m_drop_next = next_drop(now);
+        return drop();
+    }
+
+    /**
+     * @brief   Get what the shedder did.
+     */
+    load_shedding_stats get_stats() const
+    {
+        std::lock_guard lock(m_mutex);
+        return {m_shed, m_dropping, m_last_sojourn};
+    }
+
+private:
+    /**
+     * @brief   Count a drop.
+     */
+    bool drop()
+    {
+        ++m_shed;
+        return true;
+    }
+
+    /**
+     * @brief   The control law: the time of the drop following one at 'a_time'.
+     */
+    clock_t::time_point next_drop(const clock_t::time_point a_time) const
+    {
+        const auto spacing = std::chrono::duration<double, std::nano>(m_config.interval) / std::sqrt(m_count);
+        return a_time + std::chrono::duration_cast<clock_t::duration>(spacing);
+    }
+
+    // 'm_config' is a member variable that holds the settings of the shedder.
+    const load_shedding_config m_config;
+    // 'm_mutex' is a member variable that holds a mutex protecting the state of the shedder.
+    mutable std::mutex m_mutex;
+    // 'm_first_above' is a member variable that holds when the wait will have stayed above the target for an
+    // interval, or the epoch if the last wait was below it.
+    clock_t::time_point m_first_above{};
+    // 'm_drop_next' is a member variable that holds when the next delivery may be dropped.
+    clock_t::time_point m_drop_next{};
+    // 'm_dropping' is a member variable that holds whether deliveries are being dropped.
+    bool m_dropping = false;
+    // 'm_count' is a member variable that holds the number of drops of the current dropping state.
+    uint32_t m_count = 0;
+    // 'm_shed' is a member variable that holds the number of deliveries dropped.
+    uint64_t m_shed = 0;
+    // 'm_last_sojourn' is a member variable that holds how long the last delivery started waited.
+    std::chrono::nanoseconds m_last_sojourn{0};
+};
+
+/**
+ * @brief   This class bounds how many tasks run at once. Tasks over the limit are parked in a queue instead of
+ *          occupying a thread, and the task freeing a slot starts the next parked one.
+ */
+class concurrency_limiter
+{
+public:
+    /**
+     * @brief   Constructor.
+     * @param   a_limit The number of tasks that may run at once, at least 1.
+     */
+    explicit concurrency_limiter(const size_t a_limit) : m_limit(std::max<size_t>(a_limit, 1))
+    {}
+
+    /**
+     * @brief   Change the number of tasks that may run at once. Lowering it does not stop running tasks, it only
+     *          parks the next ones until enough slots are freed.
+     */
+    void set_limit(const size_t a_limit)
+    {
+        std::vector<std::function<void()>> started;
+        {
+            std::lock_guard lock(m_mutex);
+            m_limit = std::max<size_t>(a_limit, 1);
+            while(m_running < m_limit && !m_parked.empty())
+            {
+                ++m_running;
+                started.push_back(std::move(m_parked.front()));
+                m_parked.pop();
+            }
+        }
+        for(auto& start : started) start();
+    }
+
+    /**
+     * @brief   Start a task now if a slot is free, or else park it until one is. A started task must call release()
+     *          once it is done.
+     * @param   a_start The function starting the task.
+     */
+    void acquire(std::function<void()> a_start)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            if(m_closed) return;
+            if(m_running >= m_limit)
+            {
+                m_parked.push(std::move(a_start));
+                return;
+            }
+            ++m_running;
+        }
+        a_start();
+    }
+
+    /**
+     * @brief   Free the slot of a task that is done, handing it to the next parked task if any.
+     */
+    void release()
+    {
+        std::function<void()> next;
+        {
+            std::lock_guard lock(m_mutex);
+            if(m_running > m_limit || m_parked.empty())
+            {
+                --m_running;
+                return;
+            }
+            next = std::move(m_parked.front());
+            m_parked.pop();
+        }
+        next();
+    }
+
+    /**
+     * @brief   Drop the parked tasks, and every task acquiring a slot from now on.
+     */
+    void close()
+    {
+        std::queue<std::function<void()>> parked;
+        {
+            std::lock_guard lock(m_mutex);
+            m_closed = true;
+            parked.swap(m_parked);
+        }
+    }
+
+    /**
+     * @brief   Get the number of tasks parked, waiting for a slot.
+     */
+    size_t get_parked() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_parked.size();
+    }
+
+private:
+    // 'm_mutex' is a member variable that holds a mutex protecting the slots and the parked tasks.
+    mutable std::mutex m_mutex;
+    // 'm_limit' is a member variable that holds the number of tasks that may run at once.
+    size_t m_limit;
+    // 'm_running' is a member variable that holds the number of slots taken.
+    size_t m_running = 0;
+    // 'm_parked' is a member variable that holds the tasks waiting for a slot.
+    std::queue<std::function<void()>> m_parked;
+    // 'm_closed' is a member variable that holds whether the tasks are dropped rather than started.
+    bool m_closed = false;
+};
+
+/**
+ * @brief   This class holds the state an observer shares with its deliveries in flight: its callback and its
+ *          counters. The callback is published through an atomic pointer, so it can be replaced while notifications
+ *          are being posted: a post loads the pointer once and keeps the callback it loaded alive until the
+ *          invocation is over.
+ */
+class observer_state
+{
+public:
+    // 'function_t' is the type-erased callback, taking the payload tuple wrapped in a std::any.
+    typedef std::function<std::any(std::any)> function_t;
+
+    /**
+     * @brief   Constructor. This constructor publishes the first version of the callback, and links the stop token
+     *          of the observer to the one of its notification center.
+     */
+    explicit observer_state(function_t a_function, const std::stop_token& a_center_token = {}) :
+            m_function(std::make_shared<const function_t>(std::move(a_function))),
+            m_center_stop(a_center_token, stop_forwarder{&m_stop_source})
+    {}
+
+    /**
+     * @brief   Ask the deliveries of the observer to stop: queued ones are skipped and running ones can notice it
+     *          through their stop token.
+     */
+    void request_stop()
+    {
+        m_stop_source.request_stop();
+    }
+
+    /**
+     * @brief   Check whether the deliveries of the observer were asked to stop.
+     */
+    bool stop_requested() const
+    {
+        return m_stop_source.stop_requested();
+    }
+
+    /**
+     * @brief   Get the stop token of the observer.
+     */
+    std::stop_token get_stop_token() const
+    {
+        return m_stop_source.get_token();
+    }
+
+    /**
+     * @brief   Get the current version of the callback.
+     */
+    std::shared_ptr<const function_t> load() const
+    {
+        return m_function.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief   Publish a new version of the callback.
+     */
+    void store(function_t a_function)
+    {
+        m_function.store(std::make_shared<const function_t>(std::move(a_function)), std::memory_order_release);
+    }
+
+private:
+    /**
+     * @brief   This struct forwards a stop request of the notification center to the observer.
+     */
+    struct stop_forwarder
+    {
+        std::stop_source* m_source;
+        void operator()() const noexcept { m_source->request_stop(); }
+    };
+
+    // 'm_function' is a member variable that holds the current version of the callback.
+    std::atomic<std::shared_ptr<const function_t>> m_function;
+
+    // 'm_stop_source' is a member variable that holds the source of the stop token of the observer.
+    std::stop_source m_stop_source;
+
+    // 'm_center_stop' is a member variable that requests a stop of the observer when its center stops.
+    std::stop_callback<stop_forwarder> m_center_stop;
+
+public:
+    // 'm_failures' is a member variable that holds the number of deliveries in which the callback threw.
+    std::atomic<uint64_t> m_failures{0};
+
+    // 'm_gaps' is a member variable that holds the number of deliveries dropped before reaching the callback.
+    std::atomic<uint64_t> m_gaps{0};
+
+    // 'm_cost' is a member variable that holds the moving average of how long the callback runs, in nanoseconds.
+    std::atomic<int64_t> m_cost{0};
+
+    // 'm_offloaded' is a member variable that holds whether dispatch_mode::adaptive offloads the observer.
+    // It is only read and written with the lock of the notification center held.
+    bool m_offloaded = false;
+
+    // 'm_limiter' is a member variable that holds the bound on the concurrent asynchronous deliveries to the
+    // observer, or nullptr if it has none. It is only read and written with the lock of the notification center held.
+    std::shared_ptr<concurrency_limiter> m_limiter;
+
+    // 'm_domain' is a member variable that holds the cache domain the asynchronous deliveries to the observer should
+    // run in, or -1. It is only read and written with the lock of the notification center held.
+    int m_domain = -1;
+
+    // 'm_inline_deliveries' is a member variable that holds the number of adaptive deliveries run inline.
+    std::atomic<uint64_t> m_inline_deliveries{0};
+
+    // 'm_offloaded_deliveries' is a member variable that holds the number of adaptive deliveries offloaded.
+    std::atomic<uint64_t> m_offloaded_deliveries{0};
+
+    // 'm_switches' is a member variable that holds how many times the observer moved between inline and offloaded.
+    std::atomic<uint64_t> m_switches{0};
+
+    /**
+     * @brief   Add a measure of how long the callback ran to its moving average, which weighs it by 1/8.
+     */
+    void record_cost(const std::chrono::nanoseconds a_cost)
+    {
+        const auto cost = m_cost.load(std::memory_order_relaxed);
+        m_cost.store(cost == 0 ? a_cost.count() : cost + (a_cost.count() - cost) / 8, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief   This class restores the posting order of the asynchronous deliveries to a single observer. Each delivery
+ *          names the sequence number of the delivery that went through the buffer right before it, and it only runs
+ *          once that one has run: deliveries arriving early are parked and run by the worker that completes their
+ *          predecessor. No lock is held while a delivery runs.
+ */
+class reorder_buffer
+{
+public:
+    /**
+     * @brief   Constructor.
+     * @param   a_last  The sequence number of the last delivery dispatched to the observer before ordering started.
+     */
+    explicit reorder_buffer(const uint64_t a_last) : m_last(a_last), m_tail(a_last) {}
+
+    /**
+     * @brief               This method records that a delivery is going through the buffer. Deliveries that bypass
+     *                      it, e.g. synchronous ones, are not recorded, so they are never waited for. It must be
+     *                      called in dispatch order.
+     * @param a_sequence    The sequence number of the delivery.
+     * @return              The sequence number of the delivery that went through the buffer right before this one.
+     */
+    uint64_t enqueue(const uint64_t a_sequence)
+    {
+        return std::exchange(m_tail, a_sequence);
+    }
+
+    /**
+     * @brief               This method runs a delivery, or parks it until its predecessor has run.
+     * @param a_previous    The sequence number returned by enqueue() for this delivery.
+     * @param a_sequence    The sequence number of this delivery.
+     * @param a_delivery    The delivery.
+     */
+    void deliver(uint64_t a_previous, uint64_t a_sequence, std::function<void()> a_delivery)
+    {
+        std::unique_lock lock(m_mutex);
+        if(a_previous != m_last)
+        {
+            m_pending.emplace(a_previous, std::make_pair(a_sequence, std::move(a_delivery)));
+            return;
+        }
+
+        for(;;)
+        {
+            lock.unlock();
+            a_delivery();
+            lock.lock();
+
+            // The delivery has run: the one dispatched right after it, if it already arrived, can run now.
+            m_last = a_sequence;
+            const auto next = m_pending.find(m_last);
+            if(next == m_pending.end()) return;
+
+            std::tie(a_sequence, a_delivery) = std::move(next->second);
+            m_pending.erase(next);
+        }
+    }
+
+private:
+    // 'm_mutex' is a member variable that holds a mutex protecting the pending deliveries.
+    std::mutex m_mutex;
+    // 'm_last' is a member variable that holds the sequence number of the last delivery that ran.
+    uint64_t m_last;
+    // 'm_tail' is a member variable that holds the sequence number of the last delivery given to enqueue(). It is only
+    // used by the posts, which the center serializes.
+    uint64_t m_tail;
+    // 'm_pending' is a member variable that holds the deliveries that arrived early, keyed by their predecessor.
+    std::unordered_map<uint64_t, std::pair<uint64_t, std::function<void()>>> m_pending;
+};
+
+/**
+ * @brief   This class runs tasks one at a time, in the order they were pushed, on top of a thread pool. The queue
+ *          only occupies a worker while it has tasks: the first task pushed to an idle queue schedules a job that
+ *          drains it, so independent queues still run in parallel.
+ */
+class serial_queue : public std::enable_shared_from_this<serial_queue>
+{
+public:
+    /**
+     * @brief               This method pushes a task to the queue, scheduling the queue on the executor if it is idle.
+     * @param a_executor    The executor the queue runs on.
+     * @param a_task        The task.
+     */
+    template<typename Executor>
+    void push(Executor& a_executor, std::function<void()> a_task)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_tasks.push(std::move(a_task));
+            if(m_scheduled) return;
+            m_scheduled = true;
+        }
+        a_executor.push([self = shared_from_this()]{ self->drain(); });
+    }
+
+private:
+    /**
+     * @brief   This method runs the tasks of the queue until it is empty.
+     */
+    void drain()
+    {
+        std::unique_lock lock(m_mutex);
+        while(!m_tasks.empty())
+        {
+            auto task = std::move(m_tasks.front());
+            m_tasks.pop();
+
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+        m_scheduled = false;
+    }
+
+    // 'm_mutex' is a member variable that holds a mutex protecting the tasks.
+    std::mutex m_mutex;
+    // 'm_tasks' is a member variable that holds the tasks waiting to run.
+    std::queue<std::function<void()>> m_tasks;
+    // 'm_scheduled' is a member variable that holds whether a job draining the queue is scheduled or running.
+    bool m_scheduled = false;
+};
+
+/**
+ * @brief   This class shares an executor fairly between notifications. The tasks of each notification wait in a queue
+ *          of their own, and every task pushed schedules one job on the executor that runs whichever task is next in
+ *          a deficit round-robin over the non-empty queues: each queue gets a turn of as many tasks as its weight
+ *          before the next one is served. A notification flooding the executor thus only delays the tasks of another
+ *          by the turns of the queues ahead of it, not by its whole backlog.
+ */
+class fair_scheduler : public std::enable_shared_from_this<fair_scheduler>
+{
+public:
+    /**
+     * @brief               This method sets the number of tasks a notification runs per turn.
+     * @param a_notification The notification.
+     * @param a_weight      The weight, at least 1.
+     */
+    void set_weight(const int a_notification, const uint32_t a_weight)
+    {
+        std::lock_guard lock(m_mutex);
+        const auto weight = std::max<uint32_t>(a_weight, 1);
+        if(weight == 1) m_weights.erase(a_notification);
+        else m_weights[a_notification] = weight;
+
+        if(const auto flow = m_flows.find(a_notification); flow != m_flows.end()) flow->second.m_weight = weight;
+    }
+
+    /**
+     * @brief               This method pushes a task to the queue of a notification and schedules a job on the
+     *                      executor.
+     * @param a_executor    The executor the tasks run on. It must outlive the scheduled jobs.
+     * @param a_notification The notification.
+     * @param a_task        The task.
+     * @param a_serial      Whether the tasks of the notification must run one at a time, in pushing order.
+     */
+    template<typename Executor>
+    void push(Executor& a_executor, const int a_notification, std::function<void()> a_task, const bool a_serial)
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            auto [flow, inserted] = m_flows.try_emplace(a_notification);
+            if(inserted)
+            {
+                const auto weight = m_weights.find(a_notification);
+                flow->second.m_weight = weight == m_weights.end() ? 1 : weight->second;
+            }
+            flow->second.m_tasks.push(std::move(a_task));
+            flow->second.m_serial = a_serial;
+            if(!flow->second.m_listed)
+            {
+                flow->second.m_listed = true;
+                m_active.push_back(a_notification);
+            }
+        }
+        a_executor.push([self = shared_from_this(), &a_executor]{ self->run_next(a_executor); });
+    }
+
+private:
+    /**
+     * @brief   This struct holds the queue of a notification.
+     */
+    struct flow
+    {
+        // 'm_tasks' holds the tasks waiting to run.
+        std::queue<std::function<void()>> m_tasks;
+        // 'm_weight' holds the number of tasks run per turn.
+        uint32_t m_weight = 1;
+        // 'm_deficit' holds the number of tasks the queue may still run in its current turn.
+        uint32_t m_deficit = 0;
+        // 'm_serial' holds whether the tasks run one at a time.
+        bool m_serial = false;
+        // 'm_running' holds whether a task of a serial queue is running.
+        bool m_running = false;
+        // 'm_listed' holds whether the queue is in the round-robin.
+        bool m_listed = false;
+    };
+
+    /**
+     * @brief               This method runs the next task of the round-robin, if any.
+     * @param a_executor    The executor the tasks run on.
+     */
+    template<typename Executor>
+    void run_next(Executor& a_executor)
+    {
+        int notification = 0;
+        std::function<void()> task;
+        {
+            std::lock_guard lock(m_mutex);
+            if(!next(notification, task)) return;
+        }
+
+        task();
+
+        // A serial queue waits for its running task, so the job finishing it schedules the next one.
+        bool more = false;
+        {
+            std::lock_guard lock(m_mutex);
+            const auto flow = m_flows.find(notification);
+            if(flow == m_flows.end() || !flow->second.m_running) return;
+
+            flow->second.m_running = false;
+            more = !flow->second.m_tasks.empty();
+            if(!more && !flow->second.m_listed) m_flows.erase(flow);
+        }
+        if(more) a_executor.push([self = shared_from_this(), &a_executor]{ self->run_next(a_executor); });
+    }
+
+    /**
+     * @brief               This method takes the next task of the round-robin. It must be called with 'm_mutex'
+     *                      held.
+     * @param a_notification Where to store the notification of the task.
+     * @param a_task        Where to store the task.
+     * @return              Whether a task could be taken: it cannot if every queue is empty or waiting for a
+     *                      running task.
+     */
+    bool next(int& a_notification, std::function<void()>& a_task)
+    {
+        size_t skipped = 0;
+        while(skipped < m_active.size())
+        {
+            const auto notification = m_active.front();
+            auto& current = m_flows.at(notification);
+
+            if(current.m_tasks.empty())
+            {
+                m_active.pop_front();
+                current.m_listed = false;
+                current.m_deficit = 0;
+                if(!current.m_running) m_flows.erase(notification);
+                continue;
+            }
+            if(current.m_serial && current.m_running)
+            {
+                m_active.pop_front();
+                m_active.push_back(notification);
+                ++skipped;
+                continue;
+            }
+
+            // A queue reaching the front with no deficit left starts a new turn.
+            if(current.m_deficit == 0) current.m_deficit = current.m_weight;
+
+            a_notification = notification;
+            a_task = std::move(current.m_tasks.front());
+            current.m_tasks.pop();
+            current.m_running = current.m_serial;
+            if(--current.m_deficit == 0)
+            {
+                m_active.pop_front();
+                m_active.push_back(notification);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // 'm_mutex' is a member variable that holds a mutex protecting the queues.
+    std::mutex m_mutex;
+    // 'm_flows' is a member variable that holds the queue of each notification with tasks waiting or running.
+    std::unordered_map<int, flow> m_flows;
+    // 'm_active' is a member variable that holds the round-robin of the non-empty queues, the current one first.
+    std::deque<int> m_active;
+    // 'm_weights' is a member variable that holds the weight of each notification whose weight is not 1.
+    std::unordered_map<int, uint32_t> m_weights;
+};
+
+/**
+ * @brief   This struct holds the settings of a bulkhead.
+ */
+struct bulkhead_config
+{
+    // The thread pool of the bulkhead.
+    executor_config executor{4};
+};
+
+/**
+ * @brief   This struct holds the metrics of a bulkhead.
+ */
+struct bulkhead_stats
+{
+    // The number of deliveries queued on the bulkhead so far.
+    uint64_t submitted = 0;
+    // The number of deliveries the bulkhead ran.
+    uint64_t completed = 0;
+    // The number of deliveries waiting in the queue.
+    uint64_t queued = 0;
+    // The number of deliveries running.
+    uint64_t running = 0;
+    // The mean time deliveries waited in the queue.
+    std::chrono::nanoseconds mean_queue_delay{0};
+    // The longest time a delivery waited in the queue.
+    std::chrono::nanoseconds max_queue_delay{0};
+};
+
+/**
+ * @brief   This class is a bulkhead: a thread pool of its own, with its own queue, running the asynchronous deliveries
+ *          of the notifications and groups bound to it, so that a backlog elsewhere cannot delay them and theirs
+ *          cannot delay anybody else. It measures what goes through it.
+ */
+class bulkhead
+{
+public:
+    // 'clock_t' is the clock used to measure queue delays.
+    typedef std::chrono::steady_clock clock_t;
+
+    /**
+     * @brief   Constructor. This constructor starts the thread pool of the bulkhead.
+     */
+    explicit bulkhead(const bulkhead_config& a_config) : m_pool(a_config.executor)
+    {}
+
+    /**
+     * @brief           This method pushes a task to the bulkhead.
+     * @param a_task    The task.
+     * @param a_domain  The cache domain the task should run in, or -1.
+     */
+    void push(std::function<void()> a_task, const int a_domain = -1)
+    {
+        m_submitted.fetch_add(1, std::memory_order_relaxed);
+        m_pool.push([this, a_task = std::move(a_task), enqueued = clock_t::now()]
+        {
+            const auto delay = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now() - enqueued);
+            m_started.fetch_add(1, std::memory_order_relaxed);
+            m_total_delay.fetch_add(delay.count(), std::memory_order_relaxed);
+            auto longest = m_max_delay.load(std::memory_order_relaxed);
+            while(delay.count() > longest &&
+                  !m_max_delay.compare_exchange_weak(longest, delay.count(), std::memory_order_relaxed)) {}
+
+            a_task();
+            m_completed.fetch_add(1, std::memory_order_relaxed);
+        }, a_domain);
+    }
+
+    /**
+     * @brief   Get the metrics of the bulkhead.
+     */
+    bulkhead_stats get_stats() const
+    {
+        bulkhead_stats stats;
+        stats.completed = m_completed.load(std::memory_order_relaxed);
+        const auto started = std::max(m_started.load(std::memory_order_relaxed), stats.completed);
+        stats.submitted = std::max(m_submitted.load(std::memory_order_relaxed), started);
+        stats.queued = stats.submitted - started;
+        stats.running = started - stats.completed;
+        if(started != 0)
+        {
+            stats.mean_queue_delay = std::chrono::nanoseconds(m_total_delay.load(std::memory_order_relaxed) /
+                                                              static_cast<int64_t>(started));
+        }
+        stats.max_queue_delay = std::chrono::nanoseconds(m_max_delay.load(std::memory_order_relaxed));
+        return stats;
+    }
+
+    /**
+     * @brief   Get the fair scheduler used on the bulkhead under fair scheduling.
+     */
+    const std::shared_ptr<fair_scheduler>& get_fair_scheduler() const
+    {
+        return m_fair_scheduler;
+    }
+
+private:
+    // 'm_submitted' is a member variable that holds the number of tasks pushed.
+    std::atomic<uint64_t> m_submitted{0};
+    // 'm_started' is a member variable that holds the number of tasks started.
+    std::atomic<uint64_t> m_started{0};
+    // 'm_completed' is a member variable that holds the number of tasks completed.
+    std::atomic<uint64_t> m_completed{0};
+    // 'm_total_delay' is a member variable that holds the sum of the queue delays of the started tasks, in
+    // nanoseconds.
+    std::atomic<int64_t> m_total_delay{0};
+    // 'm_max_delay' is a member variable that holds the longest queue delay, in nanoseconds.
+    std::atomic<int64_t> m_max_delay{0};
+    // 'm_fair_scheduler' is a member variable that holds the fair scheduler used on the bulkhead.
+    std::shared_ptr<fair_scheduler> m_fair_scheduler = std::make_shared<fair_scheduler>();
+    // 'm_pool' is a member variable that holds the thread pool of the bulkhead. It is declared last so that it is
+    // destroyed first.
+    worker_pool m_pool;
+};
+
+/**
+ * @brief   This class counts the observers of each notification in a fixed array of atomic counters, so that a
+ *          poster can find out that nobody observes a notification without taking any lock. Notifications are mapped
+ *          to counters by their value modulo the number of counters: two notifications only share a counter if they
+ *          differ by a multiple of it, in which case the answer for one may be a false positive, never a false
+ *          negative.
+ */
+class presence_filter
+{
+public:
+    // 'slots' is the number of counters, a power of two.
+    static constexpr size_t slots = 4096;
+
+    /**
+     * @brief   Count observers added to a notification.
+     */
+    void add(const int a_notification, const uint32_t a_count = 1)
+    {
+        m_counters[slot(a_notification)].fetch_add(a_count, std::memory_order_release);
+    }
+
+    /**
+     * @brief   Count observers removed from a notification.
+     */
+    void remove(const int a_notification, const uint32_t a_count = 1)
+    {
+        m_counters[slot(a_notification)].fetch_sub(a_count, std::memory_order_release);
+    }
+
+    /**
+     * @brief   Check whether a notification may have observers. This is a single atomic load.
+     */
+    bool may_contain(const int a_notification) const
+    {
+        return m_counters[slot(a_notification)].load(std::memory_order_acquire) != 0;
+    }
+
+private:
+    /**
+     * @brief   Get the counter of a notification.
+     */
+    static constexpr size_t slot(const int a_notification)
+    {
+        return static_cast<uint32_t>(a_notification) & (slots - 1);
+    }
+
+    // 'm_counters' is a member variable that holds the number of observers of the notifications of each slot.
+    std::array<std::atomic<uint32_t>, slots> m_counters{};
+};
+
+/**
+ * @brief   This class is an observer that is used to observe notifications.
+ */
+class notification_observer
+{
+public:
+    /**
+     * @brief   Constructor. This constructor initializes the observer with a unique identifier.
+     */
+    explicit notification_observer(const int a_id, const int a_notification, std::string a_types,
+                                   const int a_group = 0, const uint64_t a_sequence = 0) :
+            m_state(nullptr),
+            m_id(a_id),
+            m_types(std::move(a_types)),
+            m_active(true),
+            m_notification(a_notification),
+            m_group(a_group),
+            m_last_dispatched(a_sequence)
+    {}
+
+    /**
+     * @brief   Get the observer id.
+     */
+    int get_id() const
+    {
+        return m_id;
+    }
+
+    /**
+     * @brief   Get the types of the arguments for the callback function.
+     */
+    std::string get_types() const
+    {
+        return m_types;
+    }
+
+    /**
+     * @brief   Get the notification the observer is observing.
+     */
+    int get_notification() const
+    {
+        return m_notification;
+    }
+
+    /**
+     * @brief   Get the group the observer belongs to.
+     */
+    int get_group() const
+    {
+        return m_group;
+    }
+
+    /**
+     * @brief   Check whether the observer is active, i.e. it has not been paused.
+     */
+    bool is_active() const
+    {
+        return m_active;
+    }
+
+    /**
+     * @brief   Pause or resume the observer.
+     */
+    void set_active(const bool a_active)
+    {
+        m_active = a_active;
+    }
+
+    /**
+     * @brief               Record that a post was dispatched to the observer.
+     * @param a_sequence    The sequence number of the post.
+     */
+    void dispatch(const uint64_t a_sequence)
+    {
+        m_last_dispatched = a_sequence;
+    }
+
+    /**
+     * @brief   Get the sequence number of the last post dispatched to the observer.
+     */
+    uint64_t get_last_dispatched() const
+    {
+        return m_last_dispatched;
+    }
+
+    // 'm_state' is a member variable that holds the callback function to be invoked when a notification is posted,
+    // along with the counters of the observer. It is shared by all the records of an observer.
+    std::shared_ptr<observer_state> m_state;
+
+    // 'm_reorder_buffer' is a member variable that holds the buffer restoring the posting order of asynchronous
+    // deliveries, or nullptr if the observer does not need them ordered.
+    std::shared_ptr<reorder_buffer> m_reorder_buffer;
+
+    // 'm_breaker' is a member variable that holds the circuit breaker of the observer, or nullptr if it has none.
+    std::shared_ptr<circuit_breaker> m_breaker;
+
+    // 'm_dependencies' is a member variable that holds the ids of the observers of the same notification that must
+    // have run before this one.
+    std::vector<int> m_dependencies;
+
+private:
+    // 'm_id' is a member variable that holds the unique identifier for the observer.
+    int m_id;
+
+    // 'm_types' is a member variable that holds the types of the arguments for the callback function.
+    std::string m_types;
+
+    // 'm_active' is a member variable that holds a flag to indicate whether the observer is active.
+    bool m_active;
+
+    // 'm_notification' is a member variable that holds the name of the notification that the observer is observing.
+    int m_notification;
+
+    // 'm_group' is a member variable that holds the group the observer belongs to.
+    int m_group;
+
+    // 'm_last_dispatched' is a member variable that holds the sequence number of the last post dispatched.
+    uint64_t m_last_dispatched;
+};
+
+class id_manager
+{
+public:
+    /**
+     * @brief   Get a unique identifier.
+     */
+    int get_unique_id()
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_released_ids.empty())
+        {
+            const int id = m_released_ids.top();
+            m_released_ids.pop();
+            m_ids.insert(id);
+            return id;
+        }
+        if(m_next_id == std::numeric_limits<int>::max()) return -1;
+
+        const int newId = m_next_id++;
+        m_ids.insert(newId);
+        return newId;
+    }
+
+    /**
+     * @brief   Release an identifier.
+     */
+    void release_id(const int id)
+    {
+        std::lock_guard lock(m_mutex);
+        m_ids.erase(id);
+        m_released_ids.push(id);
+    }
+
+private:
+    // Member variable that holds a set of all the IDs that have been used.
+    std::set<int> m_ids;
+    // Member variable that holds a stack of all the IDs that have been released.
+    std::stack<int> m_released_ids;
+    // Member variable that holds the next available ID.
+    int m_next_id = 1;
+    // Member variable that holds a mutex for thread safety.
+    std::mutex m_mutex;
+};
+
+/**
+ * @brief   This class is a notification center that allows you to post notifications to a set of observers.
+ */
+class notifly
+{
+public:
+	/**
+     * @brief   Constructor.
+     */
+    notifly() : notifly(executor_config{})
+    {}
+
+    /**
+     * @brief               Constructor.
+     * @param a_config      The settings of the thread pool running the asynchronous deliveries.
+     */
+    explicit notifly(const executor_config& a_config) : m_pool(a_config)
+    {}
+
+    /**
+     * @brief   Destructor. Asynchronous deliveries still queued are skipped, and the ones running see their stop
+     *          token signalled, before the thread pool is joined.
+     */
+    ~notifly()
+    {
+        // The posts left in the queue of try_post() are made while the rest of the center is still alive.
+        m_realtime.reset();
+
+        // A parked delivery checks this under a shared lock before it is queued, see schedule().
+        std::unique_lock lock(m_shutdown_mutex);
+        m_stop_source.request_stop();
+    }
+
+    /**
+     * @brief                   This method adds a function callback as an observer to a named notification.
+     * @param   a_notification  The name of the notification you wish to observe.
+     * @param   a_method        The function callback.
+     * @param   a_group         The group the observer belongs to, see pause_group() and resume_group().
+     * @return                  The observer id > 0 if successful or an error code
+     */
+    template<typename Callable>
+    int add_observer(int a_notification, Callable a_method, const int a_group = 0)
+    {
+        return add_observer(a_notification, std::function(std::move(a_method)), a_group);
+    }
+
+    /**
+     * @brief                   This method adds a function callback as an observer to a named notification.
+     * @param   a_notification  The name of the notification you wish to observe.
+     * @param   a_method        The function callback.
+     * @param   a_group         The group the observer belongs to, see pause_group() and resume_group().
+     * @return                  The observer id > 0 if successful or an error code
+     */
+    template<typename Return, typename ...Args>
+    int add_observer(int a_notification, std::function<Return(Args ...)> a_method, const int a_group = 0)
+    {
+        return add_observer(std::span<const int>(&a_notification, 1), std::move(a_method), a_group);
+    }
+
+    /**
+     * @brief                   This method adds a function callback as an observer to several notifications at once.
+     *                          The callback is stored once and shared by all of them, and the returned id covers
+     *                          the whole subscription: removing, pausing or replacing it applies to every
+     *                          notification.
+     * @param   a_notifications The names of the notifications you wish to observe.
+     * @param   a_method        The function callback.
+     * @param   a_group         The group the observer belongs to, see pause_group() and resume_group().
+     * @return                  The observer id > 0 if successful or an error code
+     */
+    template<typename Callable>
+    int add_observer(std::span<const int> a_notifications, Callable a_method, const int a_group = 0)
+    {
+        return add_observer(a_notifications, std::function(std::move(a_method)), a_group);
+    }
+
+    /**
+     * @brief                   This method adds a function callback as an observer to several notifications at once.
+     *                          The callback is stored once and shared by all of them, and the returned id covers
+     *                          the whole subscription: removing, pausing or replacing it applies to every
+     *                          notification.
+     * @param   a_notifications The names of the notifications you wish to observe.
+     * @param   a_method        The function callback.
+     * @param   a_group         The group the observer belongs to, see pause_group() and resume_group().
+     * @return                  The observer id > 0 if successful or an error code
+     */
+    template<typename Return, typename ...Args>
+    int add_observer(std::span<const int> a_notifications, std::function<Return(Args ...)> a_method,
+                     const int a_group = 0)
+    {
+        if(!is_valid_group(a_group)) return static_cast<int>(notifly_result::invalid_group);
+        if(a_notifications.empty()) return static_cast<int>(notifly_result::notification_not_found);
+
+        // Generate a unique string for the types of Args
+        const auto types = types_string<Args...>();
+
+        // The callback is wrapped before taking the lock, as it allocates.
+        auto state = std::make_shared<observer_state>(make_callback(std::move(a_method)), m_stop_source.get_token());
+
+        // A lock_guard object is created, locking the mutex 'm_mutex' for the duration of the scope.
+        // This ensures that the following operations are thread-safe.
+        std::lock_guard a_lock(m_mutex);
+
+        // Every notification is checked before registering anything, so a failure leaves the registry untouched.
+        for(const auto notification : a_notifications)
+        {
+            if(const auto a_notification_iterator = m_observers.find(notification);
+                a_notification_iterator != m_observers.end() &&
+                std::get<0>(a_notification_iterator->second).front().get_types() != types)
+            {
+                return static_cast<int>(notifly_result::payload_type_not_match);
+            }
+        }
+
+        // A unique id is generated for the observer.
+        const auto id = m_id_manager.get_unique_id();
+        if(id == -1) return static_cast<int>(notifly_result::no_more_observer_ids);
+
+        auto& records = m_observers_by_id[id];
+        records.reserve(a_notifications.size());
+
+        for(const auto notification : a_notifications)
+        {
+            // A notification listed twice is only observed once.
+            if(std::ranges::any_of(records, [notification](const auto& a_record)
+                                            { return std::get<0>(a_record) == notification; })) continue;
+
+            // A 'notification_observer' object is created, sharing the wrapped callback with the other records.
+            // Sequence numbers are counted from the last post, so posts made before it was added are not gaps.
+            notification_observer observer(id, notification, types, a_group, last_sequence(notification));
+            observer.m_state = state;
+
+            // The 'notification_observer' object is added to the list of observers for the notification.
+            auto& a_notification_list = std::get<0>(m_observers[notification]);
+            a_notification_list.push_back(std::move(observer));
+
+            // A tuple is created containing the notification and an iterator pointing to the last element in the
+            // list of observers, and recorded under the observer id.
+            // The '--' operator is used to get the iterator to the last element, as 'end()' returns an iterator to
+            // one past the last element.
+            records.emplace_back(notification, --a_notification_list.end());
+            m_presence.add(notification);
+        }
+
+        {
+            std::unique_lock states_lock(m_states_mutex);
+            m_states.emplace(id, std::make_pair(state, types));
+        }
+
+        // The observer id is returned from the function.
+        return id;
+    }
+
+	/**
+	 * @brief               This method removes an observer by iterator. If the observer was added to several
+	 *                      notifications at once, it is removed from all of them in a single locked pass.
+	 *                      Its asynchronous deliveries still queued are skipped, and the ones running see their
+	 *                      stop token, see current_stop_token(), signalled.
+	 * @param a_observer    The observer you wish to remove.
+	 * @return              0 if successful or an error code.
+	 */
+	int remove_observer(const int a_observer)
+    {
+        // Lock the mutex to ensure thread safety during the operation.
+        std::lock_guard a_lock(m_mutex);
+
+        // Check if the observer is not in the map of observers by id. If it's not, exit the function.
+        const auto observer_iterator = m_observers_by_id.find(a_observer);
+        if(observer_iterator == m_observers_by_id.end()) return static_cast<int>(notifly_result::observer_not_found);
+
+        // The deliveries of the observer still queued are skipped, and running ones can notice the removal.
+        std::get<1>(observer_iterator->second.front())->m_state->request_stop();
+
+        // Erase every record of the observer from the lists of observers of its notifications.
+        for(auto& [notification, iterator] : observer_iterator->second)
+        {
+            erase_record(notification, iterator);
+        }
+
+        // Finally, erase the observer from the map of observers by id.
+        m_observers_by_id.erase(observer_iterator);
+        forget_state(a_observer);
+        // Release the observer id.
+        m_id_manager.release_id(a_observer);
+
+        return static_cast<int>(notifly_result::success);
+    }
+
+    /**
+     * @brief                       This method removes all observers from a given notification, removing the
+     *                              notification from being tracked outright.
+     * @param   a_notification      The name of the notification you wish to remove.
+     * @return                      The number of observers that were successfully removed or an error code.
+     */
+    int remove_all_observers(const int a_notification)
+    {
+        // Lock the mutex to ensure thread safety during the operation.
+        std::lock_guard a_lock(m_mutex);
+
+        // Check if the notification is not in the map of observers. If it's not, exit the function.
+        if(!m_observers.contains(a_notification)) return 0;
+
+        // Get the list of observers for the given notification.
+        const auto& observers_by_notification = std::get<0>(m_observers.at(a_notification));
+
+        // Get the number of observers for the given notification.
+        const auto ret = observers_by_notification.size();
+
+        // Iterate over all observers for the given notification.
+        for(const auto& observer: observers_by_notification)
+        {
+            // Forget the record of this notification. Observers added to other notifications too stay registered
+            // for those, and keep their id.
+            auto& records = m_observers_by_id.at(observer.get_id());
+            std::erase_if(records, [a_notification](const auto& a_record)
+                                   { return std::get<0>(a_record) == a_notification; });
+            if(records.empty())
+            {
+                // The deliveries of the observer still queued are skipped.
+                observer.m_state->request_stop();
+                // Erase the observer from the map of observers by id.
+                m_observers_by_id.erase(observer.get_id());
+                forget_state(observer.get_id());
+                // Release the observer id.
+                m_id_manager.release_id(observer.get_id());
+            }
+        }
+
+        // Erase the notification from the map of observers and forget its serial queue and dependencies.
+        m_presence.remove(a_notification, static_cast<uint32_t>(ret));
+        m_observers.erase(a_notification);
+        m_dependency_edges.erase(a_notification);
+        m_serial_queues.erase(a_notification);
+
+        return static_cast<int>(ret);
+    }
+
+    /**
+     * @brief               This method replaces the callback of an existing observer. The observer keeps its id, its
+     *                      group and its place among the observers of the notification, so no post can miss it.
+     *                      Deliveries already in flight complete with the callback they started with.
+     * @param a_observer    The observer whose callback you wish to replace.
+     * @param a_method      The new function callback, which must take the same arguments as the current one.
+     * @return              0 if successful or an error code.
+     */
+    template<typename Callable>
+    int replace_observer(const int a_observer, Callable a_method)
+    {
+        return replace_observer(a_observer, std::function(std::move(a_method)));
+    }
+
+    /**
+     * @brief               This method replaces the callback of an existing observer. The observer keeps its id, its
+     *                      group and its place among the observers of the notification, so no post can miss it.
+     *                      Deliveries already in flight complete with the callback they started with. It does not
+     *                      wait for posts in progress, not even those running the observer.
+     * @param a_observer    The observer whose callback you wish to replace.
+     * @param a_method      The new function callback, which must take the same arguments as the current one.
+     * @return              0 if successful or an error code.
+     */
+    template<typename Return, typename ...Args>
+    int replace_observer(const int a_observer, std::function<Return(Args ...)> a_method)
+    {
+        const auto types = types_string<Args...>();
+
+        // The new callback is built before looking the observer up, as it allocates.
+        auto callback = make_callback(std::move(a_method));
+
+        // The state is found without 'm_mutex', which posts hold while notifying the observers.
+        std::shared_ptr<observer_state> state;
+        {
+            std::shared_lock states_lock(m_states_mutex);
+            const auto state_iterator = m_states.find(a_observer);
+            if(state_iterator == m_states.end()) return static_cast<int>(notifly_result::observer_not_found);
+            if(state_iterator->second.second != types)
+            {
+                return static_cast<int>(notifly_result::payload_type_not_match);
+            }
+            state = state_iterator->second.first;
+        }
+
+        // The new callback is published atomically: posts either see the old or the new one, never none.
+        state->store(std::move(callback));
+        return static_cast<int>(notifly_result::success);
+    }
+
+    /**
+     * @brief                   This method returns the sequence number of the last post of a notification. Each
+     *                          successful post of a notification is given the next sequence number, starting at 1.
+     * @param a_notification    The notification.
+     * @return                  The last sequence number, or 0 if the notification was never posted.
+     */
+    uint64_t last_sequence(const int a_notification) const
+    {
+        std::lock_guard a_lock(m_mutex);
+        const auto sequence_iterator = m_sequences.find(a_notification);
+        return sequence_iterator == m_sequences.end() ? 0 : sequence_iterator->second;
+    }
+
+    /**
+     * @brief   This method returns the sequence number of the post being delivered on the calling thread, so that
+     *          an observer can tell which post it is handling.
+     * @return  The sequence number, or 0 if the calling thread is not running an observer.
+     */
+    static uint64_t current_sequence()
+    {
+        return t_current_sequence;
+    }
+
+    /**
+     * @brief   This method returns the stop token of the delivery running on the calling thread. It is signalled
+     *          when the observer is removed or its notification center is destroyed, so that long-running observers
+     *          can give up early.
+     * @return  The stop token, or a token that is never signalled if the calling thread is not running an observer.
+     */
+    static std::stop_token current_stop_token()
+    {
+        return t_current_state != nullptr ? t_current_state->get_stop_token() : std::stop_token{};
+    }
+
+    /**
+     * @brief               This method makes the asynchronous deliveries to an observer run in posting order: a
+     *                      delivery that reaches a worker before the previous one has run is parked, and run right
+     *                      after it. Synchronous deliveries are always in order.
+     * @param a_observer    The observer.
+     * @param a_enabled     True to restore the posting order, false to let deliveries run as they come.
+     * @return              0 if successful or an error code.
+     */
+    int set_ordered(const int a_observer, const bool a_enabled)
+    {
+        std::lock_guard a_lock(m_mutex);
+
+        const auto observer_iterator = m_observers_by_id.find(a_observer);
+        if(observer_iterator == m_observers_by_id.end())
+        {
+            return static_cast<int>(notifly_result::observer_not_found);
+        }
+
+        for(auto& [notification, iterator] : observer_iterator->second)
+        {
+            if(!a_enabled)
+            {
+                iterator->m_reorder_buffer.reset();
+            }
+            else if(!iterator->m_reorder_buffer)
+            {
+                iterator->m_reorder_buffer = std::make_shared<reorder_buffer>(iterator->get_last_dispatched());
+            }
+        }
+        return static_cast<int>(notifly_result::success);
+    }
+
+    /**
+     * @brief               This method makes an observer run after another observer of the same notification, on
+     *                      every notification they both observe. A post to a notification whose observers depend
+     *                      on each other runs them as a graph: synchronous posts run them in a topological order,
+     *                      while asynchronous and parallel posts run independent observers in parallel on the
+     *                      thread pool, each observer starting once its dependencies have run, whether they threw
+     *                      or not. Such posts bypass the ordering set with set_async_ordering().
+     * @param a_observer    The observer that must run second.
+     * @param a_dependency  The observer that must run first.
+     * @return              0 if successful or an error code: invalid_dependency if the observers share no
+     *                      notification or if the dependency would make a cycle.
+     */
+    int add_dependency(const int a_observer, const int a_dependency)
+    {
+        std::lock_guard a_lock(m_mutex);
+
+        const auto observer_iterator = m_observers_by_id.find(a_observer);
+        const auto dependency_iterator = m_observers_by_id.find(a_dependency);
+        if(observer_iterator == m_observers_by_id.end() || dependency_iterator == m_observers_by_id.end())
+        {
+            return static_cast<int>(notifly_result::observer_not_found);
+        }
+        if(a_observer == a_dependency) return static_cast<int>(notifly_result::invalid_dependency);
+
+        // The records of the observer on the notifications the dependency observes too.
+        std::vector<observer_itr_t> records;
+        for(const auto& [notification, iterator] : observer_iterator->second)
+        {
+            if(std::ranges::any_of(dependency_iterator->second, [notification](const auto& a_record)
+                                   { return std::get<0>(a_record) == notification; }))
+            {
+                if(depends_on(notification, a_dependency, a_observer))
+                {
+                    return static_cast<int>(notifly_result::invalid_dependency);
+                }
+                records.push_back(iterator);
+            }
+        }
+        if(records.empty()) return static_cast<int>(notifly_result::invalid_dependency);
+
+        for(const auto& record : records)
+        {
+            if(std::ranges::find(record->m_dependencies, a_dependency) != record->m_dependencies.end()) continue;
+            record->m_dependencies.push_back(a_dependency);
+            ++m_dependency_edges[record->get_notification()];
+        }
+        return static_cast<int>(notifly_result::success);
+    }
+
+    /**
+     * @brief               This method removes a dependency added with add_dependency().
+     * @param a_observer    The observer that had to run second.
+     * @param a_dependency  The observer that had to run first.
+     * @return              0 if successful or an error code.
+     */
+    int remove_dependency(const int a_observer, const int a_dependency)
+    {
+        std::lock_guard a_lock(m_mutex);
+
+        const auto observer_iterator = m_observers_by_id.find(a_observer);
+        if(observer_iterator == m_observers_by_id.end())
+        {
+            return static_cast<int>(notifly_result::observer_not_found);
+        }
+
+        bool removed = false;
+        for(auto& [notification, iterator] : observer_iterator->second)
+        {
+            if(std::erase(iterator->m_dependencies, a_dependency) != 0)
+            {
+                drop_edges(notification, 1);
+                removed = true;
+            }
+        }
+        return static_cast<int>(removed ? notifly_result::success : notifly_result::invalid_dependency);
+    }
+
+    /**
+     * @brief               This method sets how asynchronous deliveries are ordered. With
+     *                      async_ordering::per_notification, the deliveries of each notification go through a
+     *                      queue of their own that runs them one at a time in posting order, while the queues of
+     *                      different notifications run in parallel on the thread pool.
+     * @param a_ordering    The ordering.
+     */
+    void set_async_ordering(const async_ordering a_ordering)
+    {
+        std::lock_guard a_lock(m_mutex);
+        m_async_ordering = a_ordering;
+    }
+
+    /**
+     * @brief               This method makes the asynchronous deliveries share the thread pool fairly between
+     *                      notifications: the deliveries of each notification wait in a queue of their own, and the
+     *                      pool serves the queues in a weighted round-robin, so that a notification posted at a
+     *                      high rate cannot starve the others. async_ordering::per_notification is honoured. It
+     *                      should be changed while no asynchronous delivery is pending.
+     * @param a_enabled     Whether fair scheduling is enabled.
+     */
+    void set_fair_scheduling(const bool a_enabled)
+    {
+        std::lock_guard a_lock(m_mutex);
+        m_fair_scheduling = a_enabled;
+    }
+
+    /**
+     * @brief               This method sets the weight of a notification under fair scheduling: the number of its
+     *                      deliveries the pool runs per round-robin turn. Notifications weigh 1 by default.
+     * @param a_notification The notification.
+     * @param a_weight      The weight; 0 counts as 1.
+     */
+    void set_notification_weight(const int a_notification, const uint32_t a_weight)
+    {
+        m_fair_scheduler->set_weight(a_notification, a_weight);
+    }
+
+    /**
+     * @brief               This method adds a bulkhead: a thread pool of its own for the asynchronous deliveries of
+     *                      the notifications and groups bound to it with bind_notification() and bind_group(), so that
+     *                      a backlog in one domain cannot raise the latency of another. Fair scheduling and
+     *                      per-notification ordering apply within each bulkhead. The limit set with
+     *                      set_notification_max_concurrency() is the exception: it bounds the deliveries of the
+     *                      notification on every executor together, so it is shared by the bulkheads its observers run
+     *                      on. Bulkheads live as long as the center.
+     * @param a_config      The settings of the bulkhead.
+     * @return              The id of the bulkhead.
+     */
+    int add_bulkhead(const bulkhead_config& a_config)
+    {
+        auto added = std::make_unique<bulkhead>(a_config);
+
+        std::lock_guard a_lock(m_mutex);
+        m_bulkheads.push_back(std::move(added));
+        return static_cast<int>(m_bulkheads.size() - 1);
+    }
+
+    /**
+     * @brief               This method runs the asynchronous deliveries of a notification on a bulkhead. The binding
+     *                      of a notification takes precedence over the one of the group of an observer.
+     * @param a_notification The notification.
+     * @param a_bulkhead    The bulkhead, or -1 to run them on the thread pool of the center again.
+     * @return              0 if successful or an error code.
+     */
+    int bind_notification(const int a_notification, const int a_bulkhead)
+    {
+        std::lock_guard a_lock(m_mutex);
+        return bind(m_notification_bulkheads, a_notification, a_bulkhead);
+    }
+
+    /**
+     * @brief               This method runs the asynchronous deliveries to the observers of a group on a bulkhead.
+     * @param a_group       The group.
+     * @param a_bulkhead    The bulkhead, or -1 to run them on the thread pool of the center again.
+     * @return              0 if successful or an error code.
+     */
+    int bind_group(const int a_group, const int a_bulkhead)
+    {
+        if(!is_valid_group(a_group)) return static_cast<int>(notifly_result::invalid_group);
+
+        std::lock_guard a_lock(m_mutex);
+        return bind(m_group_bulkheads, a_group, a_bulkhead);
+    }
+
+    /**
+     * @brief               This method returns the metrics of a bulkhead.
+     * @param a_bulkhead    The bulkhead.
+     * @param a_stats       Where to store the metrics.
+     * @return              0 if successful or an error code.
+     */
+    int get_bulkhead_stats(const int a_bulkhead, bulkhead_stats& a_stats)
+    {
+        std::lock_guard a_lock(m_mutex);
+        if(a_bulkhead < 0 || a_bulkhead >= static_cast<int>(m_bulkheads.size()))
+        {
+            return static_cast<int>(notifly_result::bulkhead_not_found);
+        }
+        a_stats = m_bulkheads[a_bulkhead]->get_stats();
+        return static_cast<int>(notifly_result::success);
+    }
+
+    /**
+     * @brief   This method returns the metrics of the thread pool of the center, with the sizing decisions it made
+     *          if it is elastic, see executor_config.
+     * @return  The metrics.
+     */
+    executor_stats get_executor_stats() const
+    {
+        return m_pool.get_stats();
+    }
+
+    /**
+     * @brief               This method keeps the asynchronous deliveries to an observer in a last level cache domain
+     *                      of the machine, the one where the data it works on is warm: they are run by the workers of
+     *                      the thread pool placed in that domain, see affinity_policy, unless all of them are busy
+     *                      while another worker is idle. Deliveries going through an ordering queue, the fair
+     *                      scheduler, the shards or the busy-polling dispatcher are not affected.
+     * @param a_id          The observer.
+     * @param a_domain      The index of the domain in cpu_topology::domains(), or -1 to let any worker run them.
+     * @return              0 if successful or an error code.
+     */
+    int set_observer_domain(const int a_id, const int a_domain)
+    {
+        if(a_domain < -1 || a_domain >= static_cast<int>(worker_pool::machine_topology().domains().size()))
+        {
+            return static_cast<int>(notifly_result::invalid_domain);
+        }
+
+        std::lock_guard a_lock(m_mutex);
+        const auto iterator = m_observers_by_id.find(a_id);
+        if(iterator == m_observers_by_id.end()) return static_cast<int>(notifly_result::observer_not_found);
+
+        std::get<1>(iterator->second.front())->m_state->m_domain = a_domain;
+        return static_cast<int>(notifly_result::success);
+    }
+
+    /**
+     * @brief               This method sets up the busy-polling dispatcher. The dispatcher is started when the first
+     *                      notification is given to it with set_busy_polling(), after which it can no longer be
+     *                      changed.
+     * @param a_config      The settings.
+     * @return              True if the settings were applied, false if the dispatcher is already running.
+     */
+    bool set_busy_poll_dispatch(const busy_poll_config& a_config)
+    {
+        std::lock_guard a_lock(m_mutex);
+        if(m_busy_poll) return false;
+        m_busy_poll_config = a_config;
+        return true;
+    }
+
+    /**
+     * @brief               This method hands the asynchronous deliveries of a notification to the busy-polling
+     *                      dispatcher: a thread of its own that spins on a lock-free queue, optionally pinned to a
+     *                      core, so that deliveries start without waking a sleeping thread. The dispatcher only spins
+     *                      while at least one notification uses it, so its core is only spent on the notifications
+     *                      that need it. The deliveries of these notifications run one at a time in posting order,
+     *                      whatever the dispatch mode of the post.
+     * @param a_notification The notification.
+     * @param a_enabled     Whether the notification uses the dispatcher.
+     */
+    void set_busy_polling(const int a_notification, const bool a_enabled)
+    {
+        std::lock_guard a_lock(m_mutex);
+        if(a_enabled)
+        {
+            if(!m_busy_poll) m_busy_poll = std::make_unique<busy_poll_dispatcher>(m_busy_poll_config);
+            m_busy_polled.insert(a_notification);
+        }
+        else
+        {
+            m_busy_polled.erase(a_notification);
+        }
+        if(m_busy_poll) m_busy_poll->set_enabled(!m_busy_polled.empty());
+    }
+
+    /**
+     * @brief               This method delivers the asynchronous posts of a notification through a ring, instead of a
+     *                      task and a copy of the payload per observer. A post writes its payload once, into a slot
+     *                      of the ring, and each observer reads it in place through a cursor of its own; an observer
+     *                      with several posts to catch up with consumes them in a single task, in posting order.
+     *                      While the slowest observer has yet to consume the post in the next slot, posts are refused
+     *                      with ring_full, so that a slow observer pushes back on the poster rather than let a queue
+     *                      grow. Posts made with other dispatch modes, or to observers depending on each other, are
+     *                      not affected.
+     * @param a_notification The notification.
+     * @param a_capacity    The number of posts the ring holds, rounded up to a power of two, or 0 to stop using a
+     *                      ring.
+     */
+    void set_ring_delivery(const int a_notification, const size_t a_capacity)
+    {
+        std::lock_guard a_lock(m_mutex);
+        if(a_capacity == 0) m_rings.erase(a_notification);
+        else m_rings[a_notification] = std::make_shared<delivery_ring>(a_notification, a_capacity);
+    }
+
+    /**
+     * @brief               This method gives a notification with a single posting thread and a single asynchronous
+     *                      observer a channel of its own: its asynchronous posts go through a wait-free single
+     *                      producer, single consumer ring, see spsc_ring, to a thread dedicated to the notification,
+     *                      instead of the queue and workers of the thread pool. Posts are still made under the lock of
+     *                      the center, checking the argument types and copying the payload as usual: the channel only
+     *                      takes the pool out of the delivery, and stays correct with more posting threads or
+     *                      observers; its deliveries run one at a time, in posting order. Posts are refused with
+     *                      ring_full while the ring has no room for a delivery to each observer. Posts made with other
+     *                      dispatch modes, or of a notification delivered through set_ring_delivery(), are not
+     *                      affected.
+     *                      Channel deliveries bypass the policies of the thread pool: they are never shed, nor held by
+     *                      concurrency limits, and they ignore bulkheads, fair scheduling, busy polling and reorder
+     *                      buffers, which their posting order makes unnecessary.
+     * @param a_notification The notification.
+     * @param a_capacity    The number of deliveries the ring holds, rounded up to a power of two, or 0 to close the
+     *                      channel once the deliveries queued ran.
+     */
+    void set_spsc_channel(const int a_notification, const size_t a_capacity)
+    {
+        std::unique_ptr<delivery_channel> closed;
+        {
+            std::lock_guard a_lock(m_mutex);
+            if(const auto channel = m_channels.find(a_notification); channel != m_channels.end())
+            {
+                closed = std::move(channel->second);
+                m_channels.erase(channel);
+            }
+            if(a_capacity != 0)
+            {
+                m_channels[a_notification] = std::make_unique<delivery_channel>(a_capacity,
+                                                                                [this](const delivery& a_delivery)
+                                                                                { deliver(a_delivery, nullptr); });
+            }
+        }
+        // The thread of the channel is joined without the lock, which its deliveries may need.
+    }
+
+    /**
+     * @brief               This method sets up the queue of try_post() and starts its dispatcher thread. The queue can
+     *                      no longer be changed once started.
+     * @param a_config      The settings.
+     * @return              True if the queue was started, false if it is already running.
+     */
+    bool set_realtime_posting(const realtime_config& a_config)
+    {
+        std::lock_guard a_lock(m_mutex);
+        if(m_realtime) return false;
+        m_realtime = std::make_unique<realtime_queue>(*this, a_config);
+        m_realtime_queue.store(m_realtime.get(), std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief   This method returns the metrics of the queue of try_post(), all zero while it is not running.
+     */
+    realtime_stats get_realtime_stats() const
+    {
+        const auto queue = m_realtime_queue.load(std::memory_order_acquire);
+        if(queue == nullptr) return {};
+        return {queue->m_queued.load(std::memory_order_relaxed), queue->m_refused.load(std::memory_order_relaxed),
+                queue->m_failed.load(std::memory_order_relaxed)};
+    }
+
+    /**
+     * @brief               This method sets up the shards of dispatch_mode::sharded. The shards are started by the
+     *                      first sharded post, after which they can no longer be changed.
+     * @param a_config      The settings.
+     * @return              True if the settings were applied, false if the shards are already running.
+     */
+    bool set_sharded_dispatch(const sharded_dispatch_config& a_config)
+    {
+        std::lock_guard a_lock(m_mutex);
+        if(m_shards) return false;
+        m_sharded_config = a_config;
+        return true;
+    }
+
+    /**
+     * @brief               This method enables the load shedding of asynchronous deliveries, see
+     *                      load_shedding_config. Only the deliveries of the notifications made sheddable with
+     *                      set_sheddable() are dropped; the others only report how long they waited. Replacing the
+     *                      settings resets the shedder.
+     * @param a_config      The settings.
+     */
+    void set_load_shedding(const load_shedding_config& a_config)
+    {
+        std::lock_guard a_lock(m_mutex);
+        m_shedder = std::make_shared<load_shedder>(a_config);
+    }
+
+    /**
+     * @brief               This method disables the load shedding of asynchronous deliveries.
+     */
+    void remove_load_shedding()
+    {
+        std::lock_guard a_lock(m_mutex);
+        m_shedder.reset();
+    }
+
+    /**
+     * @brief               This method sets whether the load shedding may drop the asynchronous deliveries of a
+     *                      notification, e.g. because they are low priority or superseded by the next post.
+     * @param a_notification The notification.
+     * @param a_sheddable   Whether its deliveries may be dropped.
+     */
+    void set_sheddable(const int a_notification, const bool a_sheddable)
+    {
+        std::lock_guard a_lock(m_mutex);
+        if(a_sheddable) m_sheddable.insert(a_notification);
+        else m_sheddable.erase(a_notification);
+    }
+
+    /**
+     * @brief               This method returns what the load shedding did.
+     * @param a_stats       Where to store the statistics.
+     * @return              True if load shedding is enabled, false otherwise.
+     */
+    bool get_load_shedding_stats(load_shedding_stats& a_stats)
+    {
+        std::lock_guard a_lock(m_mutex);
+        if(!m_shedder) return false;
+        a_stats = m_shedder->get_stats();
+        return true;
+    }
+
+    /**
+     * @brief               This method bounds how many asynchronous deliveries to an observer run at once.
+     *                      Deliveries over the limit are parked in a queue rather than occupying a pool thread, and
+     *                      started in posting order as running ones complete.
+     * @param a_id          The observer.
+     * @param a_limit       The number of deliveries that may run at once, or 0 to remove the limit.
+     * @return              0 if successful or an error code.
+     */
+    int set_max_concurrency(const int a_id, const size_t a_limit)
+    {
+        std::lock_guard a_lock(m_mutex);
+        const auto iterator = m_observers_by_id.find(a_id);
+        if(iterator == m_observers_by_id.end()) return static_cast<int>(notifly_result::observer_not_found);
+
+        auto& state = *std::get<1>(iterator->second.front())->m_state;
+        if(a_limit == 0) state.m_limiter.reset();
+        else if(state.m_limiter) state.m_limiter->set_limit(a_limit);
+        else state.m_limiter = std::make_shared<concurrency_limiter>(a_limit);
+        return static_cast<int>(notifly_result::success);
+    }
+
+    /**
+     * @brief               This method bounds how many asynchronous deliveries of a notification run at once,
+     *                      whatever their observer, like set_max_concurrency() does for a single observer. The
+     *                      limit spans every executor the deliveries run on, bulkheads included.
+     * @param a_notification The notification.
+     * @param a_limit       The number of deliveries that may run at once, or 0 to remove the limit.
+     */
+    void set_notification_max_concurrency(const int a_notification, const size_t a_limit)
+    {
+        std::lock_guard a_lock(m_mutex);
+        if(a_limit == 0)
+        {
+            m_notification_limiters.erase(a_notification);
+            return;
+        }
+
+        auto& limiter = m_notification_limiters[a_notification];
+        if(limiter) limiter->set_limit(a_limit);
+        else limiter = std::make_shared<concurrency_limiter>(a_limit);
+    }
+
+    /**
+     * @brief               This method returns how many asynchronous deliveries to an observer are parked, waiting
+     *                      for a slot of its concurrency limit.
+     * @param a_id          The observer.
+     * @return              The number of parked deliveries, or an error code.
+     */
+    int get_parked_deliveries(const int a_id)
+    {
+        std::lock_guard a_lock(m_mutex);
+        const auto iterator = m_observers_by_id.find(a_id);
+        if(iterator == m_observers_by_id.end()) return static_cast<int>(notifly_result::observer_not_found);
+
+        const auto& limiter = std::get<1>(iterator->second.front())->m_state->m_limiter;
+        return limiter ? static_cast<int>(limiter->get_parked()) : 0;
+    }
+
+    /**
+     * @brief               This method sets the thresholds used by dispatch_mode::adaptive.
+     * @param a_config      The thresholds.
+     */
+    void set_adaptive_dispatch(const adaptive_dispatch_config& a_config)
+    {
+        std::lock_guard a_lock(m_mutex);
+        m_adaptive_config = a_config;
+    }
+
+    /**
+     * @brief               This method sets the settings used by dispatch_mode::parallel.
+     * @param a_config      The settings.
+     */
+    void set_parallel_dispatch(const parallel_dispatch_config& a_config)
+    {
+        std::lock_guard a_lock(m_mutex);
+        m_parallel_config = a_config;
+    }
+
+    /**
+     * @brief               This method returns the decisions dispatch_mode::adaptive made for an observer.
+     * @param a_observer    The observer.
+     * @param a_stats       Where to store the decisions.
+     * @return              0 if successful or an error code.
+     */
+    int get_adaptive_dispatch_stats(const int a_observer, adaptive_dispatch_stats& a_stats) const
+    {
+        std::lock_guard a_lock(m_mutex);
+
+        const auto observer_iterator = m_observers_by_id.find(a_observer);
+        if(observer_iterator == m_observers_by_id.end())
+        {
+            return static_cast<int>(notifly_result::observer_not_found);
+        }
+
+        const auto& state = *std::get<1>(observer_iterator->second.front())->m_state;
+        a_stats.cost = std::chrono::nanoseconds(state.m_cost.load(std::memory_order_relaxed));
+        a_stats.offloaded = state.m_offloaded;
+        a_stats.inline_deliveries = state.m_inline_deliveries.load(std::memory_order_relaxed);
+        a_stats.offloaded_deliveries = state.m_offloaded_deliveries.load(std::memory_order_relaxed);
+        a_stats.switches = state.m_switches.load(std::memory_order_relaxed);
+        return static_cast<int>(notifly_result::success);
+    }
+
+    /**
+     * @brief               This method sets what the center does when an observer throws, see exception_policy.
+     *                      Whatever the policy, the remaining observers of the notification are still notified.
+     * @param a_policy      The policy.
+     */
+    void set_exception_policy(const exception_policy a_policy)
+    {
+        std::lock_guard a_lock(m_failure_mutex);
+        m_exception_policy = a_policy;
+    }
+
+    /**
+     * @brief               This method sets the hook receiving the exceptions thrown by observers under
+     *                      exception_policy::report. The hook may be called from a worker thread.
+     * @param a_hook        The hook, or nullptr to drop the exceptions.
+     */
+    void set_exception_hook(exception_hook_t a_hook)
+    {
+        std::lock_guard a_lock(m_failure_mutex);
+        m_exception_hook = std::move(a_hook);
+    }
+
+    /**
+     * @brief   This method returns the exceptions captured so far, see exception_policy, and forgets them.
+     * @return  The captured exceptions, oldest first.
+     */
+    std::vector<std::exception_ptr> take_exceptions()
+    {
+        std::lock_guard a_lock(m_failure_mutex);
+        return std::exchange(m_exceptions, {});
+    }
+
+    /**
+     * @brief               This method gives an observer a circuit breaker, which skips it for a while when too
+     *                      many of its deliveries throw or are slow, see circuit_breaker. Setting a breaker again
+     *                      starts it over, closed.
+     * @param a_observer    The observer.
+     * @param a_config      The thresholds of the breaker.
+     * @return              0 if successful or an error code.
+     */
+    int set_circuit_breaker(const int a_observer, const circuit_breaker_config& a_config)
+    {
+        return set_breaker(a_observer, std::make_shared<circuit_breaker>(a_config));
+    }
+
+    /**
+     * @brief               This method removes the circuit breaker of an observer.
+     * @param a_observer    The observer.
+     * @return              0 if successful or an error code.
+     */
+    int remove_circuit_breaker(const int a_observer)
+    {
+        return set_breaker(a_observer, nullptr);
+    }
+
+    /**
+     * @brief               This method sets the hook receiving the transitions of the circuit breakers of the
+     *                      observers. The hook may be called from a worker thread.
+     * @param a_hook        The hook, or nullptr.
+     */
+    void set_circuit_breaker_hook(breaker_hook_t a_hook)
+    {
+        std::lock_guard a_lock(m_failure_mutex);
+        m_breaker_hook = std::move(a_hook);
+    }
+
+    /**
+     * @brief               This method returns the state of the circuit breaker of an observer. Observers without a
+     *                      breaker are always closed.
+     * @param a_observer    The observer.
+     * @return              The state of the breaker.
+     */
+    breaker_state get_circuit_breaker_state(const int a_observer) const
+    {
+        std::lock_guard a_lock(m_mutex);
+
+        const auto observer_iterator = m_observers_by_id.find(a_observer);
+        if(observer_iterator == m_observers_by_id.end()) return breaker_state::closed;
+
+        const auto& breaker = std::get<1>(observer_iterator->second.front())->m_breaker;
+        return breaker ? breaker->get_state() : breaker_state::closed;
+    }
+
+    /**
+     * @brief               This method returns how many times an observer threw while being notified.
+     * @param a_observer    The observer.
+     * @return              The number of failures or an error code.
+     */
+    int64_t get_failure_count(const int a_observer) const
+    {
+        std::lock_guard a_lock(m_mutex);
+
+        const auto observer_iterator = m_observers_by_id.find(a_observer);
+        if(observer_iterator == m_observers_by_id.end())
+        {
+            return static_cast<int>(notifly_result::observer_not_found);
+        }
+
+        // All the records of an observer share the same state.
+        const auto& state = *std::get<1>(observer_iterator->second.front())->m_state;
+        return static_cast<int64_t>(state.m_failures.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief               This method returns how many posts an observer missed: deliveries dispatched to it that
+     *                      were dropped before reaching its callback, e.g. shed under load or skipped because the
+     *                      center was stopping. Posts skipped on purpose, while the observer or its group was paused
+     *                      or its circuit breaker open, are not counted, nor are posts refused with ring_full, which
+     *                      are given no sequence number.
+     * @param a_observer    The observer.
+     * @return              The number of missed posts or an error code.
+     */
+    int64_t get_gap_count(const int a_observer) const
+    {
+        std::lock_guard a_lock(m_mutex);
+
+        const auto observer_iterator = m_observers_by_id.find(a_observer);
+        if(observer_iterator == m_observers_by_id.end())
+        {
+            return static_cast<int>(notifly_result::observer_not_found);
+        }
+
+        // All the records of an observer share the same state.
+        const auto& state = *std::get<1>(observer_iterator->second.front())->m_state;
+        return static_cast<int64_t>(state.m_gaps.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief               This method pauses an observer. A paused observer stays registered and keeps its id, but
+     *                      it is skipped by post_notification until it is resumed.
+     * @param a_observer    The observer you wish to pause.
+     * @return              0 if successful or an error code.
+     */
+    int pause_observer(const int a_observer)
+    {
+        return set_observer_active(a_observer, false);
+    }
+
+    /**
+     * @brief               This method resumes an observer previously paused with pause_observer().
+     * @param a_observer    The observer you wish to resume.
+     * @return              0 if successful or an error code.
+     */
+    int resume_observer(const int a_observer)
+    {
+        return set_observer_active(a_observer, true);
+    }
+
+    /**
+     * @brief               This method pauses every observer of a group, across all notifications. It only flips a
+     *                      bit of an atomic mask, so it neither takes the lock nor touches the registry.
+     * @param a_group       The group you wish to pause, in the range [0, max_observer_groups).
+     * @return              0 if successful or an error code.
+     */
+    int pause_group(const int a_group)
+    {
+        if(!is_valid_group(a_group)) return static_cast<int>(notifly_result::invalid_group);
+        m_paused_groups.fetch_or(group_bit(a_group), std::memory_order_release);
+        return static_cast<int>(notifly_result::success);
+    }
+
+    /**
+     * @brief               This method resumes every observer of a group previously paused with pause_group().
+     * @param a_group       The group you wish to resume, in the range [0, max_observer_groups).
+     * @return              0 if successful or an error code.
+     */
+    int resume_group(const int a_group)
+    {
+        if(!is_valid_group(a_group)) return static_cast<int>(notifly_result::invalid_group);
+        m_paused_groups.fetch_and(~group_bit(a_group), std::memory_order_release);
+        return static_cast<int>(notifly_result::success);
+    }
+
+    /**
+     * @brief               This method checks whether a group is currently paused.
+     * @param a_group       The group you wish to check.
+     * @return              True if the group is valid and paused, false otherwise.
+     */
+    bool is_group_paused(const int a_group) const
+    {
+        return is_valid_group(a_group) &&
+               (m_paused_groups.load(std::memory_order_acquire) & group_bit(a_group)) != 0;
+    }
+
+    /**
+     * @brief                   This method posts a notification to a set of observers. If successful, this function
+     *                          calls all callbacks associated with that notification and return true.
+     *                          If no such notification exists, this function will print a warning to the console and
+     *                          return false.
+     *
+     * @param a_notification    The name of the notification you wish to post.
+     * @param args              The payload associated with the specified notification.
+     * @param a_async           If false, this function will run in the same thread as the caller.
+     *                          If true, this function will run in a separate thread.
+     * @return                  Number of observers that were successfully notified or an error code. Paused
+     *                          observers are not counted.
+     */
+    template<typename ...Args>
+    int post_notification(const int a_notification, Args... args, const bool a_async = false)
+    {
+        return post_notification<Args...>(a_notification, args...,
+                                          a_async ? dispatch_mode::async : dispatch_mode::sync);
+    }
+
+    /**
+     * @brief                   This method posts a notification to a set of observers, choosing where they run.
+     *
+     * @param a_notification    The name of the notification you wish to post.
+     * @param args              The payload associated with the specified notification.
+     * @param a_mode            Where the observers run, see dispatch_mode.
+     * @return                  Number of observers that were successfully notified or an error code. Paused
+     *                          observers are not counted.
+     */
+    template<typename ...Args>
+    int post_notification(const int a_notification, Args... args, const dispatch_mode a_mode)
+    {
+        // Posts of notifications nobody observes return before building anything or taking the lock.
+        if(!has_observers(a_notification))
+        {
+            return static_cast<int>(notifly_result::notification_not_found);
+        }
+
+        // Generate a unique string for the types of Args
+        const auto types = types_string<Args...>();
+
+        // A unique_lock object is created, locking the mutex 'm_mutex' for the duration of the scope.
+        // This ensures that the following operations are thread-safe.
+        std::unique_lock a_lock(m_mutex);
+
+        // Check if the types string matches the one saved in the map
+        if(!m_observers.contains(a_notification))
+        {
+            return static_cast<int>(notifly_result::notification_not_found);
+        }
+        if (std::get<0>(m_observers[a_notification]).front().get_types() != types)
+        {
+            return static_cast<int>(notifly_result::payload_type_not_match);
+        }
+
+        // A std::tuple of the arguments is created and wrapped in a std::any.
+        auto payload = std::make_any<std::tuple<Args...>>(std::make_tuple(args...));
+
+        // The code attempts to find the notification 'a_notification' in the 'm_observers' map.
+        const auto a_notification_iterator = m_observers.find(a_notification);
+
+        // If the notification is found, it retrieves the list of observers for that notification.
+        auto& a_notification_list = std::get<0>(a_notification_iterator->second);
+
+        // Asynchronous posts of a notification delivered through a ring write the payload once, into the next slot,
+        // and are refused while an observer has yet to consume the post in it.
+        std::shared_ptr<delivery_ring> ring;
+        // Those of a notification with a single producer, single consumer channel go to the ring of the channel,
+        // and are refused while it has no room for a delivery to each observer.
+        delivery_channel* channel = nullptr;
+        if(a_mode == dispatch_mode::async && !m_dependency_edges.contains(a_notification))
+        {
+            if(const auto found = m_rings.find(a_notification); found != m_rings.end())
+            {
+                ring = found->second;
+                ring->sync(a_notification_list);
+                if(ring->full()) return static_cast<int>(notifly_result::ring_full);
+            }
+            else if(const auto found_channel = m_channels.find(a_notification); found_channel != m_channels.end())
+            {
+                channel = found_channel->second.get();
+                if(channel->m_deliveries.free_slots() < a_notification_list.size())
+                {
+                    return static_cast<int>(notifly_result::ring_full);
+                }
+            }
+        }
+        const auto slot = ring ? ring->m_published.load(std::memory_order_relaxed) & ring->mask() : 0;
+        size_t position = 0;
+
+        // The post is given the next sequence number of the notification.
+        const auto sequence = ++m_sequences[a_notification];
+
+        // The mask of paused groups is loaded once, so that pausing costs a single load for the whole fan-out.
+        const auto paused_groups = m_paused_groups.load(std::memory_order_acquire);
+        int notified = 0;
+
+        // The first exception thrown by a synchronous observer, rethrown under exception_policy::propagate.
+        std::exception_ptr first_exception;
+
+        // When observers of the notification depend on each other, the deliveries are gathered here and run as a
+        // graph once every observer has been visited.
+        std::shared_ptr<dependency_graph> graph;
+        if(m_dependency_edges.contains(a_notification))
+        {
+            graph = std::make_shared<dependency_graph>();
+            graph->m_deliveries.reserve(a_notification_list.size());
+        }
+
+        // In dispatch_mode::parallel, the deliveries are gathered here and run once the lock is released. Below the
+        // threshold, the post falls back to a serial synchronous one.
+        std::shared_ptr<fork_join> parallel;
+        if(!graph && a_mode == dispatch_mode::parallel && a_notification_list.size() >= m_parallel_config.serial_below)
+        {
+            parallel = std::make_shared<fork_join>();
+            parallel->m_deliveries.reserve(a_notification_list.size());
+        }
+
+        // It then iterates over each observer in the list.
+        for (auto& callback : a_notification_list)
+        {
+            // The cursor of the observer is told the post is skipped, unless it turns out to get it.
+            auto* permit_slot = ring ? &ring->m_cursors[position++]->m_permits[slot] : nullptr;
+            if(permit_slot) *permit_slot = circuit_breaker::permit::denied;
+
+            // Paused observers, or observers belonging to a paused group, are skipped.
+            if(!callback.is_active() || (paused_groups & group_bit(callback.get_group())) != 0)
+            {
+                continue;
+            }
+
+            // Observers whose circuit breaker is open are skipped as well.
+            auto permit = circuit_breaker::permit::granted;
+            if(callback.m_breaker)
+            {
+                permit = callback.m_breaker->allow(transition_listener(callback.get_id()));
+                if(permit == circuit_breaker::permit::denied)
+                {
+                    continue;
+                }
+            }
+
+            callback.dispatch(sequence);
+
+            // Observers reading from the ring are scheduled once the post is published.
+            if(permit_slot)
+            {
+                *permit_slot = permit;
+                ++notified;
+                continue;
+            }
+
+            // The current version of the callback is loaded once, so a concurrent replace_observer() cannot change
+            // it in the middle of this delivery.
+            delivery a_delivery{callback.m_state, callback.m_state->load(), callback.m_breaker, permit, payload,
+                                sequence, callback.get_id(), a_notification, a_mode == dispatch_mode::adaptive};
+
+            if(graph)
+            {
+                graph->m_deliveries.push_back(std::move(a_delivery));
+                graph->m_dependencies.push_back(callback.m_dependencies);
+            }
+            else if(parallel)
+            {
+                parallel->m_deliveries.push_back(std::move(a_delivery));
+            }
+            // If the observer is offloaded, it pushes the callback function to the thread pool for asynchronous
+            // execution. The callback function is invoked with 'a_payload' as its argument.
+            else if(a_mode == dispatch_mode::async || a_mode == dispatch_mode::sharded ||
+                    (a_mode == dispatch_mode::adaptive && offload(*callback.m_state)))
+            {
+                ++notified;
+
+                // The deliveries of a channel already run in posting order, and its thread is woken once per post.
+                // The room of the ring was checked before the loop and posts are serialized, so the push cannot
+                // fail; should it ever, the delivery takes the thread pool rather than being lost.
+                if(channel)
+                {
+                    if(!channel->m_deliveries.try_push(a_delivery))
+                    {
+                        schedule(callback, a_mode, [this, a_delivery = std::move(a_delivery)]
+                                                   { deliver(a_delivery, nullptr); });
+                    }
+                    continue;
+                }
+
+                // Under load shedding, the delivery is stamped with when it was queued. A dropped delivery still
+                // consumed its sequence number, and deliver() adds it to the gap count of the observer.
+                if(m_shedder)
+                {
+                    a_delivery.m_shedder = m_shedder;
+                    a_delivery.m_enqueued = load_shedder::clock_t::now();
+                    a_delivery.m_sheddable = m_sheddable.contains(a_notification);
+                }
+
+                // Observers that need their deliveries in posting order go through their reorder buffer.
+                if(auto buffer = callback.m_reorder_buffer)
+                {
+                    const auto previous = buffer->enqueue(sequence);
+                    schedule(callback, a_mode, [this, buffer = std::move(buffer), a_delivery = std::move(a_delivery),
+                                                previous]() mutable
+                    {
+                        // A delivery parked by the buffer outlives this task, so it takes the delivery along.
+                        const auto sequence = a_delivery.m_sequence;
+                        buffer->deliver(previous, sequence, [this, a_delivery = std::move(a_delivery)]
+                                                            { deliver(a_delivery, nullptr); });
+                    });
+                }
+                else
+                {
+                    schedule(callback, a_mode, [this, a_delivery = std::move(a_delivery)]
+                                               { deliver(a_delivery, nullptr); });
+                }
+            }
+            // Otherwise, it directly invokes the callback function with 'a_payload' as its argument.
+            else if(deliver(a_delivery, &first_exception))
+            {
+                ++notified;
+            }
+        }
+
+        if(channel)
+        {
+            channel->wake();
+        }
+        else if(ring)
+        {
+            ring->publish(std::move(payload), sequence);
+            position = 0;
+            for(const auto& callback : a_notification_list)
+            {
+                const auto& cursor = ring->m_cursors[position++];
+                if(cursor->m_permits[slot] != circuit_breaker::permit::denied && !cursor->m_scheduled.exchange(true))
+                {
+                    schedule(callback, a_mode, [this, ring, cursor]{ drain(ring, cursor); });
+                }
+            }
+        }
+        else if(graph)
+        {
+            graph->link();
+            if(a_mode == dispatch_mode::sync)
+            {
+                notified = run_graph_serially(*graph, first_exception);
+            }
+            else
+            {
+                // The observers run without the lock, so that they may use the center from any thread.
+                a_lock.unlock();
+                notified = run_graph(graph, a_mode == dispatch_mode::parallel, first_exception);
+            }
+        }
+        else if(parallel)
+        {
+            // The observers run without the lock, so that they may use the center from any thread.
+            a_lock.unlock();
+            notified = run_parallel(*parallel, parallel, first_exception);
+        }
+
+        // Under exception_policy::propagate, the first exception reaches the poster once everybody was notified.
+        if(first_exception) std::rethrow_exception(first_exception);
+
+        // If the notification is found and the callbacks are successfully invoked, it returns how many were notified.
+        return notified;
+    }
+
+    /**
+     * @brief                   This method checks whether a notification has observers. It is wait-free: a single
+     *                          atomic load, without taking the lock. It never misses an observed notification, but
+     *                          it may report observers for a notification differing from an observed one by a
+     *                          multiple of presence_filter::slots.
+     * @param a_notification    The notification.
+     * @return                  False if nobody observes the notification.
+     */
+    bool has_observers(const int a_notification) const
+    {
+        return m_presence.may_contain(a_notification);
+    }
+
+    /**
+     * @brief                   This method posts a notification whose payload is only built if it is going to be
+     *                          delivered: the factory is not called when nobody observes the notification, when its
+     *                          observers take a different payload, or when all of them are paused or have their
+     *                          circuit breaker open. The factory runs without the lock of the center.
+     * @param a_notification    The name of the notification you wish to post.
+     * @param a_factory         A callable building the payload. It returns either the single argument of the
+     *                          notification or a std::tuple of its arguments.
+     * @param a_async           If false, this function will run in the same thread as the caller.
+     *                          If true, this function will run in a separate thread.
+     * @return                  Number of observers that were successfully notified or an error code.
+     */
+    template<typename Factory>
+    int post_lazy(const int a_notification, Factory&& a_factory, const bool a_async = false)
+    {
+        if(!has_observers(a_notification))
+        {
+            return static_cast<int>(notifly_result::notification_not_found);
+        }
+
+        using payload_t = std::invoke_result_t<Factory&>;
+        return post_lazy(a_notification, std::forward<Factory>(a_factory), a_async,
+                         static_cast<payload_tuple_t<payload_t>*>(nullptr));
+    }
+
+    // 'realtime_payload_size' holds the largest payload, in bytes, that try_post() can queue.
+    static constexpr size_t realtime_payload_size = 48;
+
+    /**
+     * @brief                   This method posts a notification from a thread that must never block nor allocate,
+     *                          such as an audio or control-loop thread. It neither takes the lock of the center nor
+     *                          builds the payload: the arguments are copied byte for byte into a slot of the queue
+     *                          started by set_realtime_posting(), a lock-free ring allocated up front, and the post is
+     *                          made by the dispatcher thread of the queue, as post_notification() would. The arguments
+     *                          must be trivially copyable and fit in realtime_payload_size bytes.
+     *
+     * @param a_notification    The name of the notification you wish to post.
+     * @param args              The payload associated with the specified notification.
+     * @param a_async           If false, the observers run on the dispatcher thread.
+     *                          If true, they run on the thread pool.
+     * @return                  success once queued, or an error code: ring_full when the queue is full,
+     *                          realtime_disabled when it is not running. Errors of the post itself, made later, are
+     *                          only counted, see get_realtime_stats().
+     */
+    template<typename ...Args>
+    int try_post(const int a_notification, Args... args, const bool a_async = false)
+    {
+        return try_post<Args...>(a_notification, args..., a_async ? dispatch_mode::async : dispatch_mode::sync);
+    }
+
+    /**
+     * @brief                   This method posts a notification from a thread that must never block nor allocate,
+     *                          choosing where the observers run, see try_post() and dispatch_mode.
+     *
+     * @param a_notification    The name of the notification you wish to post.
+     * @param args              The payload associated with the specified notification.
+     * @param a_mode            Where the observers run, once the dispatcher thread makes the post.
+     * @return                  success once queued, or an error code.
+     */
+    template<typename ...Args>
+    int try_post(const int a_notification, Args... args, const dispatch_mode a_mode)
+    {
+        static_assert((std::is_trivially_copyable_v<Args> && ...), "try_post() needs trivially copyable arguments");
+        static_assert(((alignof(Args) <= alignof(std::max_align_t)) && ...), "try_post() arguments are over-aligned");
+        constexpr auto layout = realtime_layout<Args...>();
+        static_assert(layout.back() <= realtime_payload_size, "try_post() arguments exceed realtime_payload_size");
+
+        const auto queue = m_realtime_queue.load(std::memory_order_acquire);
+        if(queue == nullptr) return static_cast<int>(notifly_result::realtime_disabled);
+        if(!has_observers(a_notification))
+        {
+            return static_cast<int>(notifly_result::notification_not_found);
+        }
+
+        realtime_post post;
+        post.m_post = &post_realtime<Args...>;
+        post.m_notification = a_notification;
+        post.m_mode = a_mode;
+        size_t index = 0;
+        ((std::memcpy(post.m_payload + layout[index++], &args, sizeof(Args))), ...);
+
+        if(!queue->m_posts.try_push(post))
+        {
+            queue->m_refused.fetch_add(1, std::memory_order_relaxed);
+            return static_cast<int>(notifly_result::ring_full);
+        }
+        queue->m_queued.fetch_add(1, std::memory_order_relaxed);
+        return static_cast<int>(notifly_result::success);
+    }
+
+    /**
+     * @brief   This method returns the default global notification center. You may alternatively create your
+     *          own notification center without using the default notification center.
+     */
+    static notifly& default_notifly()
+    {
+        // Guaranteed to be destroyed. Instantiated on first use.
+        static notifly a_notification;
+
+        return a_notification;
+    }
+
+private:
+    /** === Private types === **/
+	typedef std::list<notification_observer>::iterator observer_itr_t;
+	typedef std::tuple<int, observer_itr_t>  notification_tuple_t;
+	typedef std::tuple<std::list<notification_observer>, std::unique_ptr<std::mutex>> notification_info_t;
+
+    /**
+     * @brief   This struct holds everything needed to deliver a post to an observer, here or on a worker thread.
+     */
+    struct delivery
+    {
+        // 'm_state' holds the state of the observer.
+        std::shared_ptr<observer_state> m_state;
+        // 'm_function' holds the version of the callback loaded when the post was made.
+        std::shared_ptr<const observer_state::function_t> m_function;
+        // 'm_breaker' holds the circuit breaker of the observer, or nullptr.
+        std::shared_ptr<circuit_breaker> m_breaker;
+        // 'm_permit' holds the permit the circuit breaker gave to the delivery.
+        circuit_breaker::permit m_permit;
+        // 'm_payload' holds the payload of the post.
+        std::any m_payload;
+        // 'm_sequence' holds the sequence number of the post.
+        uint64_t m_sequence;
+        // 'm_observer' holds the observer id.
+        int m_observer;
+        // 'm_notification' holds the notification.
+        int m_notification;
+        // 'm_measured' holds whether the cost of the callback must be measured, for dispatch_mode::adaptive.
+        bool m_measured;
+        // 'm_shedder' holds the load shedder of a queued delivery, or nullptr.
+        std::shared_ptr<load_shedder> m_shedder = nullptr;
+        // 'm_enqueued' holds when a queued delivery was queued.
+        load_shedder::clock_t::time_point m_enqueued{};
+        // 'm_sheddable' holds whether the load shedder may drop the delivery.
+        bool m_sheddable = false;
+        // 'm_shared_payload' holds the payload of the post when it is read in place instead of 'm_payload'.
+        const std::any* m_shared_payload = nullptr;
+    };
+
+    /**
+     * @brief   This struct holds the deliveries of a post made with dispatch_mode::parallel, shared by the caller
+     *          thread and the pool workers helping it. Chunks of deliveries are claimed through an atomic index, so
+     *          a worker arriving after all of them were claimed just leaves.
+     */
+    struct fork_join
+    {
+        // 'm_deliveries' holds the deliveries of the post.
+        std::vector<delivery> m_deliveries;
+        // 'm_chunk_size' holds the number of deliveries in a chunk.
+        size_t m_chunk_size = 1;
+        // 'm_chunks' holds the number of chunks.
+        size_t m_chunks = 0;
+        // 'm_exceptions' holds the first exception of each chunk, kept under exception_policy::propagate.
+        std::vector<std::exception_ptr> m_exceptions;
+        // 'm_next' holds the index of the next chunk to claim.
+        std::atomic<size_t> m_next{0};
+        // 'm_notified' holds the number of observers successfully notified.
+        std::atomic<int> m_notified{0};
+        // 'm_mutex' holds a mutex protecting 'm_done'.
+        std::mutex m_mutex;
+        // 'm_done_cv' holds a condition variable signalled when the last chunk is done.
+        std::condition_variable m_done_cv;
+        // 'm_done' holds the number of chunks done.
+        size_t m_done = 0;
+    };
+
+    /**
+     * @brief   This struct holds the position of an observer in the ring of its notification, see
+     *          set_ring_delivery(). A single drain of the cursor runs at a time, so the observer gets the posts in
+     *          order, and consumes all those published since its last drain in one go.
+     */
+    struct ring_cursor
+    {
+        // 'm_state' holds the state of the observer.
+        std::shared_ptr<observer_state> m_state;
+        // 'm_breaker' holds the circuit breaker of the observer, or nullptr.
+        std::shared_ptr<circuit_breaker> m_breaker;
+        // 'm_observer' holds the observer id.
+        int m_observer;
+        // 'm_permits' holds, for each slot, whether the observer gets the post in it. It is written by the poster
+        // before the post is published.
+        std::vector<circuit_breaker::permit> m_permits;
+        // 'm_next' holds the position of the next post to consume. The slots before it are free for the poster.
+        alignas(64) std::atomic<uint64_t> m_next;
+        // 'm_end' holds the position where the cursor stops, once its observer left the ring.
+        std::atomic<uint64_t> m_end{std::numeric_limits<uint64_t>::max()};
+        // 'm_scheduled' holds whether a drain of the cursor is queued or running.
+        std::atomic<bool> m_scheduled{false};
+    };
+
+    /**
+     * @brief   This struct holds the ring of a notification delivered through set_ring_delivery(). Posts are made
+     *          under 'm_mutex', so there is a single producer: it writes the payload of a post once, into the slot of
+     *          its position, and publishes it; each observer reads it in place through its own cursor. A slot is only
+     *          written again once every cursor, including those of observers that left with posts to consume, went
+     *          past it.
+     */
+    struct delivery_ring
+    {
+        /**
+         * @brief   This struct holds a slot of the ring.
+         */
+        struct slot
+        {
+            // 'm_payload' holds the payload of the post.
+            std::any m_payload;
+            // 'm_sequence' holds the sequence number of the post.
+            uint64_t m_sequence = 0;
+        };
+
+        delivery_ring(const int a_notification, const size_t a_capacity) :
+                m_notification(a_notification), m_slots(std::bit_ceil(std::max<size_t>(a_capacity, 2)))
+        {}
+
+        /**
+         * @brief               Match the cursors with the observers of the notification, in the same order. New
+         *                      observers start at the next post, and observers that left consume the posts published
+         *                      so far. An observer whose circuit breaker changed gets a new cursor as well.
+         * @param a_observers   The observers of the notification.
+         */
+        void sync(const std::list<notification_observer>& a_observers)
+        {
+            const auto same = [](const notification_observer& a_observer, const std::shared_ptr<ring_cursor>& a_cursor)
+            {
+                return a_cursor && a_cursor->m_observer == a_observer.get_id() &&
+                       a_cursor->m_breaker == a_observer.m_breaker;
+            };
+            if(std::ranges::equal(a_observers, m_cursors, same)) return;
+
+            const auto published = m_published.load(std::memory_order_relaxed);
+            std::vector<std::shared_ptr<ring_cursor>> cursors;
+            cursors.reserve(a_observers.size());
+            for(const auto& observer : a_observers)
+            {
+                const auto kept = std::ranges::find_if(m_cursors, [&](const auto& a_cursor)
+                {
+                    return same(observer, a_cursor);
+                });
+                if(kept != m_cursors.end())
+                {
+                    cursors.push_back(std::move(*kept));
+                    continue;
+                }
+                auto& cursor = cursors.emplace_back(std::make_shared<ring_cursor>());
+                cursor->m_state = observer.m_state;
+                cursor->m_breaker = observer.m_breaker;
+                cursor->m_observer = observer.get_id();
+                cursor->m_permits.resize(m_slots.size(), circuit_breaker::permit::denied);
+                cursor->m_next.store(published, std::memory_order_relaxed);
+            }
+            for(auto& cursor : m_cursors)
+            {
+                if(!cursor) continue;
+                cursor->m_end.store(published, std::memory_order_release);
+                m_leaving.push_back(std::move(cursor));
+            }
+            m_cursors = std::move(cursors);
+        }
+
+        /**
+         * @brief   Check whether the slot of the next post is still to be consumed by a cursor. The slowest cursor is
+         *          only looked for once the one found last time could be holding the slot back.
+         */
+        bool full()
+        {
+            const auto position = m_published.load(std::memory_order_relaxed);
+            if(position - m_gate < m_slots.size()) return false;
+
+            std::erase_if(m_leaving, [](const std::shared_ptr<ring_cursor>& a_cursor)
+            {
+                const auto end = a_cursor->m_end.load(std::memory_order_relaxed);
+                return a_cursor->m_next.load(std::memory_order_acquire) >= end;
+            });
+            m_gate = position;
+            for(const auto* cursors : {&m_cursors, &m_leaving})
+            {
+                for(const auto& cursor : *cursors)
+                {
+                    m_gate = std::min(m_gate, cursor->m_next.load(std::memory_order_acquire));
+                }
+            }
+            return position - m_gate >= m_slots.size();
+        }
+
+        /**
+         * @brief               Publish the next post. The permits of the cursors must have been written.
+         * @param a_payload     The payload of the post.
+         * @param a_sequence    The sequence number of the post.
+         */
+        void publish(std::any&& a_payload, const uint64_t a_sequence)
+        {
+            const auto position = m_published.load(std::memory_order_relaxed);
+            for(const auto& cursor : m_cursors)
+            {
+                // A cursor with nothing left to consume skips a post it does not get right away, so that no drain
+                // is needed for it.
+                if(cursor->m_permits[position & mask()] == circuit_breaker::permit::denied &&
+                   cursor->m_next.load(std::memory_order_relaxed) == position)
+                {
+                    cursor->m_next.store(position + 1, std::memory_order_release);
+                }
+            }
+            auto& published = m_slots[position & mask()];
+            published.m_payload = std::move(a_payload);
+            published.m_sequence = a_sequence;
+            m_published.store(position + 1);
+        }
+
+        /**
+         * @brief   Get the mask wrapping positions to slots.
+         */
+        size_t mask() const
+        {
+            return m_slots.size() - 1;
+        }
+
+        // 'm_notification' holds the notification.
+        const int m_notification;
+        // 'm_slots' holds the slots.
+        std::vector<slot> m_slots;
+        // 'm_cursors' holds the cursors of the observers of the notification, in their order.
+        std::vector<std::shared_ptr<ring_cursor>> m_cursors;
+        // 'm_leaving' holds the cursors of observers that left, until they consumed the posts made before.
+        std::vector<std::shared_ptr<ring_cursor>> m_leaving;
+        // 'm_gate' holds the position of the slowest cursor when it was last looked for.
+        uint64_t m_gate = 0;
+        // 'm_published' holds the number of posts published.
+        alignas(64) std::atomic<uint64_t> m_published{0};
+    };
+
+    /**
+     * @brief   This struct holds the channel of a notification delivered through set_spsc_channel(): a single
+     *          producer, single consumer ring of deliveries, filled by posts under 'm_mutex', and a thread of its own
+     *          running them in order. The thread spins for a while once the ring is empty, then sleeps until a post
+     *          wakes it.
+     */
+    struct delivery_channel
+    {
+        delivery_channel(const size_t a_capacity, std::function<void(const delivery&)> a_deliver) :
+                m_deliveries(a_capacity), m_deliver(std::move(a_deliver)), m_thread([this]{ run(); })
+        {}
+
+        ~delivery_channel()
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                m_stop = true;
+            }
+            m_wakeup.notify_one();
+            m_thread.join();
+        }
+
+        /**
+         * @brief   Wake the thread if it sleeps, once deliveries were pushed.
+         */
+        void wake()
+        {
+            // Either the thread sees the deliveries before sleeping, or it is seen sleeping here.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(!m_sleeping.load(std::memory_order_relaxed)) return;
+            {
+                std::lock_guard lock(m_mutex);
+            }
+            m_wakeup.notify_one();
+        }
+
+        /**
+         * @brief   Run the deliveries until the channel is destroyed and its ring is empty.
+         */
+        void run()
+        {
+            delivery a_delivery{};
+            uint32_t spins = 0;
+            for(;;)
+            {
+                if(m_deliveries.try_pop(a_delivery))
+                {
+                    m_deliver(a_delivery);
+                    a_delivery = {};
+                    spins = 0;
+                    continue;
+                }
+                if(++spins < 1024)
+                {
+                    cpu_relax();
+                    continue;
+                }
+
+                std::unique_lock lock(m_mutex);
+                m_sleeping.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                m_wakeup.wait(lock, [this]{ return !m_deliveries.empty() || m_stop; });
+                m_sleeping.store(false, std::memory_order_relaxed);
+                if(m_stop && m_deliveries.empty()) return;
+                spins = 0;
+            }
+        }
+
+        // 'm_deliveries' holds the deliveries waiting to run.
+        spsc_ring<delivery> m_deliveries;
+        // 'm_deliver' holds the function running a delivery.
+        std::function<void(const delivery&)> m_deliver;
+        // 'm_sleeping' holds whether the thread sleeps, or is about to.
+        std::atomic<bool> m_sleeping{false};
+        // 'm_stop' holds whether the channel is being destroyed.
+        bool m_stop = false;
+        // 'm_mutex' holds a mutex used to sleep.
+        std::mutex m_mutex;
+        // 'm_wakeup' holds a condition variable signalled when deliveries are pushed to a sleeping thread.
+        std::condition_variable m_wakeup;
+        // 'm_thread' holds the thread running the deliveries. It is declared last, so that it starts last.
+        std::thread m_thread;
+    };
+
+    /**
+     * @brief   This struct holds a post made with try_post(). Its arguments are copied as bytes, so that queuing it
+     *          neither allocates nor runs a constructor, and are read back by the function of their types.
+     */
+    struct realtime_post
+    {
+        // 'm_post' holds the function making the post, knowing the types of its arguments.
+        int (*m_post)(notifly&, const realtime_post&) = nullptr;
+        // 'm_notification' holds the notification posted.
+        int m_notification = 0;
+        // 'm_mode' holds where the observers run.
+        dispatch_mode m_mode = dispatch_mode::sync;
+        // 'm_payload' holds the bytes of the arguments, laid out by realtime_layout().
+        alignas(std::max_align_t) std::byte m_payload[realtime_payload_size];
+    };
+
+    /**
+     * @brief   This struct holds the queue of try_post(): a lock-free ring of posts, and a thread making them. The
+     *          thread is never woken by the posting threads: once the ring is empty, it sleeps for the poll interval.
+     */
+    struct realtime_queue
+    {
+        realtime_queue(notifly& a_center, const realtime_config& a_config) :
+                m_center(a_center), m_posts(a_config.capacity), m_poll_interval(a_config.poll_interval),
+                m_thread([this]{ run(); })
+        {}
+
+        ~realtime_queue()
+        {
+            {
+                std::lock_guard lock(m_mutex);
+                m_stop = true;
+            }
+            m_wakeup.notify_one();
+            m_thread.join();
+        }
+
+        /**
+         * @brief   Make the posts of the ring until the queue is destroyed and its ring is empty.
+         */
+        void run()
+        {
+            std::array<realtime_post, 32> posts;
+            for(;;)
+            {
+                const auto count = m_posts.try_pop_bulk(posts);
+                for(size_t i = 0; i < count; ++i)
+                {
+                    // Under exception_policy::propagate, an observer throwing during the post rethrows here, where
+                    // nobody could catch it: the post counts as failed instead.
+                    try
+                    {
+                        if(posts[i].m_post(m_center, posts[i]) >= 0) continue;
+                    }
+                    catch(...) {}
+                    m_failed.fetch_add(1, std::memory_order_relaxed);
+                }
+                if(count != 0) continue;
+
+                std::unique_lock lock(m_mutex);
+                if(m_stop) return;
+                m_wakeup.wait_for(lock, m_poll_interval, [this]{ return m_stop; });
+            }
+        }
+
+        // 'm_center' holds the center the posts are made to.
+        notifly& m_center;
+        // 'm_posts' holds the posts waiting to be made.
+        mpmc_ring<realtime_post> m_posts;
+        // 'm_poll_interval' holds how long the thread sleeps once the ring is empty.
+        std::chrono::microseconds m_poll_interval;
+        // 'm_queued' holds the number of posts queued.
+        alignas(64) std::atomic<uint64_t> m_queued{0};
+        // 'm_refused' holds the number of posts refused because the ring was full.
+        std::atomic<uint64_t> m_refused{0};
+        // 'm_failed' holds the number of posts the thread could not make.
+        alignas(64) std::atomic<uint64_t> m_failed{0};
+        // 'm_stop' holds whether the queue is being destroyed.
+        bool m_stop = false;
+        // 'm_mutex' holds a mutex used to sleep.
+        std::mutex m_mutex;
+        // 'm_wakeup' holds a condition variable signalled when the queue is destroyed.
+        std::condition_variable m_wakeup;
+        // 'm_thread' holds the thread making the posts. It is declared last, so that it starts last.
+        std::thread m_thread;
+    };
+
+    /**
+     * @brief   This struct holds the deliveries of a post to observers that depend on each other. Each delivery
+     *          counts the dependencies it still waits for, and the delivery completing the last of them runs it.
+     */
+    struct dependency_graph
+    {
+        // 'm_deliveries' holds the deliveries of the post.
+        std::vector<delivery> m_deliveries;
+        // 'm_dependencies' holds the ids of the observers each delivery depends on.
+        std::vector<std::vector<int>> m_dependencies;
+        // 'm_dependents' holds the indexes of the deliveries depending on each delivery.
+        std::vector<std::vector<size_t>> m_dependents;
+        // 'm_pending' holds the number of dependencies each delivery still waits for.
+        std::unique_ptr<std::atomic<size_t>[]> m_pending;
+        // 'm_exceptions' holds the exception of each delivery, kept under exception_policy::propagate when the
+        // poster waits for the graph.
+        std::vector<std::exception_ptr> m_exceptions;
+        // 'm_remaining' holds the number of deliveries that have not run yet.
+        std::atomic<size_t> m_remaining{0};
+        // 'm_notified' holds the number of observers successfully notified.
+        std::atomic<int> m_notified{0};
+        // 'm_waited' holds whether the poster waits for the graph to complete.
+        bool m_waited = false;
+        // 'm_ready' holds the indexes of the deliveries ready to run and not claimed yet, when the poster waits for
+        // the graph. It is protected by 'm_mutex'.
+        std::deque<size_t> m_ready;
+        // 'm_mutex' holds a mutex used to wait for the graph to complete.
+        std::mutex m_mutex;
+        // 'm_done_cv' holds a condition variable signalled when a delivery gets ready or the last delivery has run.
+        std::condition_variable m_done_cv;
+
+        /**
+         * @brief   Resolve the dependencies between the deliveries. Dependencies on observers that are not notified by
+         *          this post, e.g. because they are paused, are already satisfied.
+         */
+        void link()
+        {
+            const auto size = m_deliveries.size();
+            std::unordered_map<int, size_t> indexes;
+            for(size_t i = 0; i < size; ++i)
+            {
+                indexes.emplace(m_deliveries[i].m_observer, i);
+            }
+
+            m_dependents.resize(size);
+            m_pending = std::make_unique<std::atomic<size_t>[]>(size);
+            for(size_t i = 0; i < size; ++i)
+            {
+                for(const auto dependency : m_dependencies[i])
+                {
+                    if(const auto index = indexes.find(dependency); index != indexes.end())
+                    {
+                        m_dependents[index->second].push_back(i);
+                        m_pending[i].fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+            m_remaining.store(size);
+        }
+    };
+
+    /**
+     * @brief   This method lays the arguments of try_post() out in the payload of a realtime_post, each at the first
+     *          offset suiting its alignment.
+     * @return  The offset of each argument, followed by the size of the payload.
+     */
+    template<typename ...Args>
+    static constexpr std::array<size_t, sizeof...(Args) + 1> realtime_layout()
+    {
+        std::array<size_t, sizeof...(Args) + 1> layout{};
+        size_t offset = 0;
+        size_t index = 0;
+        ((offset = (offset + alignof(Args) - 1) / alignof(Args) * alignof(Args), layout[index++] = offset,
+          offset += sizeof(Args)), ...);
+        layout[index] = offset;
+        return layout;
+    }
+
+    /**
+     * @brief   This method makes a post queued by try_post(), on the dispatcher thread of the queue.
+     * @return  The result of post_notification().
+     */
+    template<typename ...Args>
+    static int post_realtime(notifly& a_center, const realtime_post& a_post)
+    {
+        return post_realtime<Args...>(a_center, a_post, std::index_sequence_for<Args...>{});
+    }
+
+    /**
+     * @brief   This method implements post_realtime() once the indexes of the arguments are known.
+     */
+    template<typename ...Args, size_t ...Indexes>
+    static int post_realtime(notifly& a_center, const realtime_post& a_post, std::index_sequence<Indexes...>)
+    {
+        [[maybe_unused]] constexpr auto layout = realtime_layout<Args...>();
+        return a_center.post_notification<Args...>(a_post.m_notification,
+                                                   read_realtime<Args>(a_post.m_payload + layout[Indexes])...,
+                                                   a_post.m_mode);
+    }
+
+    /**
+     * @brief   This method reads an argument back from the payload of a realtime_post.
+     */
+    template<typename T>
+    static T read_realtime(const std::byte* a_bytes)
+    {
+        std::array<std::byte, sizeof(T)> bytes;
+        std::memcpy(bytes.data(), a_bytes, sizeof(T));
+        return std::bit_cast<T>(bytes);
+    }
+
+    /**
+     * @brief   This trait maps the value returned by a post_lazy() factory to the std::tuple of the arguments of the
+     *          notification: a std::tuple is used as is, any other value is the single argument.
+     */
+    template<typename T>
+    struct payload_tuple
+    {
+        typedef std::tuple<T> type;
+    };
+
+    template<typename ...Args>
+    struct payload_tuple<std::tuple<Args...>>
+    {
+        typedef std::tuple<Args...> type;
+    };
+
+    template<typename T>
+    using payload_tuple_t = typename payload_tuple<std::remove_cvref_t<T>>::type;
+
+    /** === Private methods === **/
+    /**
+     * @brief                   This method implements post_lazy() once the arguments of the notification are known.
+     */
+    template<typename Factory, typename ...Args>
+    int post_lazy(const int a_notification, Factory&& a_factory, const bool a_async, std::tuple<Args...>*)
+    {
+        const auto types = types_string<Args...>();
+
+        // The observers are only checked under the lock: the factory runs without it, so that building the payload
+        // does not hold back the other posts of the center. The post checks the observers again, so observers that
+        // changed in between cost at most a payload built for nothing.
+        {
+            std::lock_guard a_lock(m_mutex);
+
+            const auto a_notification_iterator = m_observers.find(a_notification);
+            if(a_notification_iterator == m_observers.end())
+            {
+                return static_cast<int>(notifly_result::notification_not_found);
+            }
+            const auto& a_notification_list = std::get<0>(a_notification_iterator->second);
+            if(a_notification_list.front().get_types() != types)
+            {
+                return static_cast<int>(notifly_result::payload_type_not_match);
+            }
+
+            // The factory is not called when no observer would be notified.
+            const auto paused_groups = m_paused_groups.load(std::memory_order_acquire);
+            if(std::ranges::none_of(a_notification_list, [paused_groups](const notification_observer& a_observer)
+            {
+                return a_observer.is_active() && (paused_groups & group_bit(a_observer.get_group())) == 0 &&
+                       (!a_observer.m_breaker || a_observer.m_breaker->may_allow());
+            }))
+            {
+                return 0;
+            }
+        }
+
+        std::tuple<Args...> payload = std::invoke(std::forward<Factory>(a_factory));
+        return std::apply([&](Args&... args)
+        {
+            return post_notification<Args...>(a_notification, args..., a_async);
+        }, payload);
+    }
+
+    /**
+     * @brief               This method invokes the callback of a delivery, making the sequence number of the post
+     *                      and the stop token of the observer available to it through current_sequence() and
+     *                      current_stop_token().
+     * @param a_delivery    The delivery.
+     * @return              The value returned by the callback.
+     */
+    static std::any invoke(const delivery& a_delivery)
+    {
+        // The previous values are restored afterwards, as an observer may post synchronously itself.
+        struct delivery_scope
+        {
+            uint64_t m_sequence = t_current_sequence;
+            const observer_state* m_state = t_current_state;
+            ~delivery_scope()
+            {
+                t_current_sequence = m_sequence;
+                t_current_state = m_state;
+            }
+        } scope;
+        t_current_sequence = a_delivery.m_sequence;
+        t_current_state = a_delivery.m_state.get();
+
+        return (*a_delivery.m_function)(a_delivery.m_shared_payload ? *a_delivery.m_shared_payload
+                                                                     : a_delivery.m_payload);
+    }
+
+    /**
+     * @brief               This method returns a listener passing the transitions of the circuit breaker of an
+     *                      observer to the hook set with set_circuit_breaker_hook().
+     * @param a_observer    The observer id.
+     */
+    auto transition_listener(const int a_observer)
+    {
+        return [this, a_observer](const breaker_state a_from, const breaker_state a_to)
+        {
+            std::unique_lock a_lock(m_failure_mutex);
+            if(auto hook = m_breaker_hook)
+            {
+                a_lock.unlock();
+                hook(a_observer, a_from, a_to);
+            }
+        };
+    }
+
+    /**
+     * @brief                   This method delivers a post to an observer, applying the exception policy if it
+     *                          throws. Nothing but the try block is added to deliveries that do not throw, unless
+     *                          the observer has a circuit breaker or is dispatched adaptively, which need them
+     *                          timed. Deliveries whose observer
+     *                          was asked to stop are skipped.
+     * @param a_delivery        The delivery.
+     * @param a_first_exception Where to keep the first exception of a synchronous post under
+     *                          exception_policy::propagate, or nullptr for asynchronous deliveries.
+     * @return                  True if the observer did not throw.
+     */
+    bool deliver(const delivery& a_delivery, std::exception_ptr* a_first_exception)
+    {
+        // Deliveries of an observer that was removed, or whose center is being destroyed, are skipped. Queued
+        // deliveries report their wait to the load shedder, which may drop them. Probe deliveries of a circuit
+        // breaker are kept, as the breaker waits for their outcome. Either way, the observer misses the post.
+        const auto shed = [&a_delivery]
+        {
+            return a_delivery.m_shedder &&
+                   a_delivery.m_shedder->shed(a_delivery.m_enqueued, a_delivery.m_sheddable &&
+                                              a_delivery.m_permit != circuit_breaker::permit::probe);
+        };
+        if(a_delivery.m_state->stop_requested() || shed())
+        {
+            a_delivery.m_state->m_gaps.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if(!a_delivery.m_breaker && !a_delivery.m_measured) return invoke_guarded(a_delivery, a_first_exception);
+
+        const auto start = circuit_breaker::clock_t::now();
+        const bool succeeded = invoke_guarded(a_delivery, a_first_exception);
+        const auto latency = circuit_breaker::clock_t::now() - start;
+
+        if(a_delivery.m_breaker)
+        {
+            a_delivery.m_breaker->record(a_delivery.m_permit, !succeeded, latency,
+                                         transition_listener(a_delivery.m_observer));
+        }
+        if(a_delivery.m_measured)
+        {
+            a_delivery.m_state->record_cost(std::chrono::duration_cast<std::chrono::nanoseconds>(latency));
+        }
+        return succeeded;
+    }
+
+    /**
+     * @brief                   This method invokes the callback of a delivery, applying the exception policy if it
+     *                          throws.
+     * @param a_delivery        The delivery.
+     * @param a_first_exception Where to keep the first exception of a synchronous post under
+     *                          exception_policy::propagate, or nullptr for asynchronous deliveries.
+     * @return                  True if the observer did not throw.
+     */
+    bool invoke_guarded(const delivery& a_delivery, std::exception_ptr* a_first_exception)
+    {
+        try
+        {
+            invoke(a_delivery);
+            return true;
+        }
+        catch(...)
+        {
+            a_delivery.m_state->m_failures.fetch_add(1, std::memory_order_relaxed);
+            handle_failure(a_delivery.m_observer, a_delivery.m_notification, std::current_exception(),
+                           a_first_exception);
+            return false;
+        }
+    }
+
+    /**
+     * @brief                   This method applies the exception policy to an exception thrown by an observer.
+     * @param a_observer        The observer id.
+     * @param a_notification    The notification.
+     * @param a_exception       The exception.
+     * @param a_first_exception Where to keep the first exception of a synchronous post under
+     *                          exception_policy::propagate, or nullptr for asynchronous deliveries.
+     */
+    void handle_failure(const int a_observer, const int a_notification, std::exception_ptr a_exception,
+                        std::exception_ptr* a_first_exception)
+    {
+        std::unique_lock a_lock(m_failure_mutex);
+        switch(m_exception_policy)
+        {
+            case exception_policy::propagate:
+                if(a_first_exception != nullptr)
+                {
+                    if(!*a_first_exception) *a_first_exception = std::move(a_exception);
+                    return;
+                }
+                m_exceptions.push_back(std::move(a_exception));
+                return;
+            case exception_policy::capture:
+                m_exceptions.push_back(std::move(a_exception));
+                return;
+            case exception_policy::report:
+                // The hook is called without the lock, so that it may change the policy or take the exceptions.
+                if(auto hook = m_exception_hook)
+                {
+                    a_lock.unlock();
+                    hook(a_observer, a_notification, std::move(a_exception));
+                }
+                return;
+        }
+    }
+
+    /**
+     * @brief                   This method runs a dependency graph on the caller thread, in a topological order.
+     *                          It is called with 'm_mutex' held, like any synchronous post.
+     * @param a_graph           The graph.
+     * @param a_first_exception Where to keep the first exception under exception_policy::propagate.
+     * @return                  The number of observers successfully notified.
+     */
+    int run_graph_serially(dependency_graph& a_graph, std::exception_ptr& a_first_exception)
+    {
+        std::queue<size_t> ready;
+        for(size_t i = 0; i < a_graph.m_deliveries.size(); ++i)
+        {
+            if(a_graph.m_pending[i].load(std::memory_order_relaxed) == 0) ready.push(i);
+        }
+
+        int notified = 0;
+        while(!ready.empty())
+        {
+            const auto node = ready.front();
+            ready.pop();
+
+            notified += deliver(a_graph.m_deliveries[node], &a_first_exception);
+            for(const auto dependent : a_graph.m_dependents[node])
+            {
+                if(a_graph.m_pending[dependent].fetch_sub(1, std::memory_order_relaxed) == 1) ready.push(dependent);
+            }
+        }
+        return notified;
+    }
+
+    /**
+     * @brief                   This method runs a dependency graph on the thread pool: the deliveries without
+     *                          dependencies are pushed right away, and each delivery pushes the dependents it was
+     *                          the last dependency of once it has run. A waiting caller claims ready deliveries as
+     *                          well, so that the graph completes even when the caller is the only free pool worker.
+     * @param a_graph           The graph.
+     * @param a_wait            Whether to wait for the whole graph to complete.
+     * @param a_first_exception Where to keep the first exception under exception_policy::propagate, if waiting.
+     * @return                  The number of observers successfully notified if waiting, or else the number of
+     *                          deliveries pushed.
+     */
+    int run_graph(const std::shared_ptr<dependency_graph>& a_graph, const bool a_wait,
+                  std::exception_ptr& a_first_exception)
+    {
+        const auto size = a_graph->m_deliveries.size();
+        if(size == 0) return 0;
+
+        a_graph->m_waited = a_wait;
+        if(a_wait) a_graph->m_exceptions.resize(size);
+
+        std::vector<size_t> roots;
+        for(size_t i = 0; i < size; ++i)
+        {
+            if(a_graph->m_pending[i].load(std::memory_order_relaxed) == 0) roots.push_back(i);
+        }
+        push_graph_nodes(a_graph, roots);
+        if(!a_wait) return static_cast<int>(size);
+
+        for(;;)
+        {
+            size_t node;
+            {
+                std::unique_lock lock(a_graph->m_mutex);
+                a_graph->m_done_cv.wait(lock, [&a_graph]
+                {
+                    return !a_graph->m_ready.empty() || a_graph->m_remaining.load() == 0;
+                });
+                if(a_graph->m_ready.empty()) break;
+                node = a_graph->m_ready.front();
+                a_graph->m_ready.pop_front();
+            }
+            run_graph_node(a_graph, node);
+        }
+
+        for(auto& exception : a_graph->m_exceptions)
+        {
+            if(exception)
+            {
+                a_first_exception = std::move(exception);
+                break;
+            }
+        }
+        return a_graph->m_notified.load();
+    }
+
+    /**
+     * @brief               This method hands deliveries of a dependency graph that are ready to run to the thread
+     *                      pool. When the poster waits for the graph, they are queued in the graph first, and each
+     *                      pool task claims whichever is still there, leaving nothing to do if the poster got it.
+     * @param a_graph       The graph.
+     * @param a_nodes       The indexes of the deliveries.
+     */
+    void push_graph_nodes(const std::shared_ptr<dependency_graph>& a_graph, const std::vector<size_t>& a_nodes)
+    {
+        if(a_nodes.empty()) return;
+
+        std::vector<std::function<void()>> tasks;
+        if(!a_graph->m_waited)
+        {
+            for(const auto node : a_nodes)
+            {
+                tasks.emplace_back([this, a_graph, node]{ run_graph_node(a_graph, node); });
+            }
+            m_pool.push_bulk(std::move(tasks));
+            return;
+        }
+
+        {
+            std::lock_guard lock(a_graph->m_mutex);
+            a_graph->m_ready.insert(a_graph->m_ready.end(), a_nodes.begin(), a_nodes.end());
+            a_graph->m_done_cv.notify_all();
+        }
+        tasks.assign(a_nodes.size(), [this, a_graph]
+        {
+            size_t node;
+            {
+                std::lock_guard lock(a_graph->m_mutex);
+                if(a_graph->m_ready.empty()) return;
+                node = a_graph->m_ready.front();
+                a_graph->m_ready.pop_front();
+            }
+            run_graph_node(a_graph, node);
+        });
+        m_pool.push_bulk(std::move(tasks));
+    }
+
+    /**
+     * @brief               This method runs a delivery of a dependency graph, then pushes the dependents it was the
+     *                      last dependency of.
+     * @param a_graph       The graph.
+     * @param a_node        The index of the delivery.
+     */
+    void run_graph_node(const std::shared_ptr<dependency_graph>& a_graph, const size_t a_node)
+    {
+        auto* exception = a_graph->m_waited ? &a_graph->m_exceptions[a_node] : nullptr;
+        a_graph->m_notified.fetch_add(deliver(a_graph->m_deliveries[a_node], exception));
+
+        std::vector<size_t> ready;
+        for(const auto dependent : a_graph->m_dependents[a_node])
+        {
+            if(a_graph->m_pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) ready.push_back(dependent);
+        }
+        push_graph_nodes(a_graph, ready);
+
+        // The dependents are pushed before the delivery counts as done, so the graph cannot look complete early.
+        if(a_graph->m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1 && a_graph->m_waited)
+        {
+            std::lock_guard lock(a_graph->m_mutex);
+            a_graph->m_done_cv.notify_all();
+        }
+    }
+
+    /**
+     * @brief                   This method runs the deliveries of a post made with dispatch_mode::parallel: the
+     *                          caller thread and up to 'max_helpers' pool workers claim chunks of them until none is
+     *                          left, and the method returns once every chunk is done.
+     * @param a_fork_join       The deliveries.
+     * @param a_shared          The shared pointer owning the deliveries, kept alive by the helpers.
+     * @param a_first_exception Where to keep the first exception under exception_policy::propagate.
+     * @return                  The number of observers successfully notified.
+     */
+    int run_parallel(fork_join& a_fork_join, const std::shared_ptr<fork_join>& a_shared,
+                     std::exception_ptr& a_first_exception)
+    {
+        // With every observer paused or rejected by its circuit breaker, there is nothing to fork.
+        const auto size = a_fork_join.m_deliveries.size();
+        if(size == 0) return 0;
+        a_fork_join.m_chunk_size = std::max<size_t>(m_parallel_config.chunk_size, 1);
+        a_fork_join.m_chunks = (size + a_fork_join.m_chunk_size - 1) / a_fork_join.m_chunk_size;
+        a_fork_join.m_exceptions.resize(a_fork_join.m_chunks);
+
+        const auto helpers = std::min(a_fork_join.m_chunks - 1, m_parallel_config.max_helpers);
+        m_pool.push_bulk(std::vector<std::function<void()>>(helpers, [this, a_shared]{ run_chunks(*a_shared); }));
+        run_chunks(a_fork_join);
+
+        {
+            std::unique_lock lock(a_fork_join.m_mutex);
+            a_fork_join.m_done_cv.wait(lock, [&a_fork_join]{ return a_fork_join.m_done == a_fork_join.m_chunks; });
+        }
+
+        for(auto& exception : a_fork_join.m_exceptions)
+        {
+            if(exception)
+            {
+                a_first_exception = std::move(exception);
+                break;
+            }
+        }
+        return a_fork_join.m_notified.load();
+    }
+
+    /**
+     * @brief               This method claims chunks of the deliveries of a post made with dispatch_mode::parallel
+     *                      and runs them, until none is left.
+     * @param a_fork_join   The deliveries.
+     */
+    void run_chunks(fork_join& a_fork_join)
+    {
+        for(auto chunk = a_fork_join.m_next.fetch_add(1); chunk < a_fork_join.m_chunks;
+            chunk = a_fork_join.m_next.fetch_add(1))
+        {
+            const auto begin = chunk * a_fork_join.m_chunk_size;
+            const auto end = std::min(begin + a_fork_join.m_chunk_size, a_fork_join.m_deliveries.size());
+
+            int notified = 0;
+            for(auto i = begin; i < end; ++i)
+            {
+                notified += deliver(a_fork_join.m_deliveries[i], &a_fork_join.m_exceptions[chunk]);
+            }
+            a_fork_join.m_notified.fetch_add(notified);
+
+            std::lock_guard lock(a_fork_join.m_mutex);
+            if(++a_fork_join.m_done == a_fork_join.m_chunks) a_fork_join.m_done_cv.notify_all();
+        }
+    }
+
+    /**
+     * @brief           This method decides whether dispatch_mode::adaptive offloads an observer to the thread pool,
+     *                  moving it between inline and offloaded as its cost crosses the thresholds set with
+     *                  set_adaptive_dispatch(). It must be called with 'm_mutex' held.
+     * @param a_state   The state of the observer.
+     * @return          True if the observer is offloaded.
+     */
+    bool offload(observer_state& a_state)
+    {
+        const auto cost = std::chrono::nanoseconds(a_state.m_cost.load(std::memory_order_relaxed));
+        if(a_state.m_offloaded ? cost < m_adaptive_config.inline_below : cost > m_adaptive_config.offload_above)
+        {
+            a_state.m_offloaded = !a_state.m_offloaded;
+            a_state.m_switches.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        auto& deliveries = a_state.m_offloaded ? a_state.m_offloaded_deliveries : a_state.m_inline_deliveries;
+        deliveries.fetch_add(1, std::memory_order_relaxed);
+        return a_state.m_offloaded;
+    }
+
+    /**
+     * @brief               This method delivers the posts published in a ring to the observer of a cursor, until the
+     *                      cursor has caught up with the ring.
+     * @param a_ring        The ring.
+     * @param a_cursor      The cursor.
+     */
+    void drain(const std::shared_ptr<delivery_ring>& a_ring, const std::shared_ptr<ring_cursor>& a_cursor)
+    {
+        auto& cursor = *a_cursor;
+        const auto published = [&]
+        {
+            return std::min(a_ring->m_published.load(), cursor.m_end.load(std::memory_order_acquire));
+        };
+
+        for(;;)
+        {
+            // The position is read after the ring, as the poster may have moved the cursor past the posts it does
+            // not get before publishing them.
+            const auto last = published();
+            auto next = cursor.m_next.load(std::memory_order_acquire);
+            for(; next < last; ++next)
+            {
+                const auto index = next & a_ring->mask();
+                if(const auto permit = cursor.m_permits[index]; permit != circuit_breaker::permit::denied)
+                {
+                    const auto& slot = a_ring->m_slots[index];
+                    delivery a_delivery{cursor.m_state, cursor.m_state->load(), cursor.m_breaker, permit, {},
+                                        slot.m_sequence, cursor.m_observer, a_ring->m_notification, false};
+                    a_delivery.m_shared_payload = &slot.m_payload;
+                    deliver(a_delivery, nullptr);
+                }
+                // Once the cursor moves past it, the slot may be written again.
+                cursor.m_next.store(next + 1, std::memory_order_release);
+            }
+
+            // A post published after the check above either finds the drain no longer scheduled and schedules
+            // another one, or is seen here.
+            cursor.m_scheduled.store(false);
+            if(published() == next || cursor.m_scheduled.exchange(true)) return;
+        }
+    }
+
+    /**
+     * @brief                   This method schedules an asynchronous delivery on the thread pool, honouring the
+     *                          concurrency limits of the observer and of the notification. It must be called with
+     *                          'm_mutex' held.
+     * @param a_observer        The record of the observer being notified.
+     * @param a_mode            The dispatch mode of the post.
+     * @param a_delivery        The delivery.
+     */
+    void schedule(const notification_observer& a_observer, const dispatch_mode a_mode,
+                  std::function<void()> a_delivery)
+    {
+        const auto a_notification = a_observer.get_notification();
+        const auto& a_observer_limiter = a_observer.m_state->m_limiter;
+
+        // The executor is resolved now, as a parked delivery is resumed by a pool worker without the lock.
+        auto enqueue = executor_for(a_notification, a_mode, a_observer.get_group(), a_observer.m_state->m_domain);
+
+        std::shared_ptr<concurrency_limiter> notification_limiter;
+        if(const auto limiter = m_notification_limiters.find(a_notification); limiter != m_notification_limiters.end())
+        {
+            notification_limiter = limiter->second;
+        }
+        if(!notification_limiter && !a_observer_limiter)
+        {
+            enqueue(std::move(a_delivery));
+            return;
+        }
+
+        // Once it holds a slot of each limit, the delivery is queued, and it frees them when done. A parked delivery
+        // is resumed by whichever thread frees a slot, a shard, busy-poll or bulkhead thread included, possibly
+        // while the center is destroyed: once it is stopping, the delivery and those still parked are dropped, as
+        // the executors may be gone already.
+        std::function<void()> start = [this, enqueue, notification_limiter, a_observer_limiter,
+                                       a_delivery = std::move(a_delivery)]
+        {
+            std::shared_lock lock(m_shutdown_mutex);
+            if(m_stop_source.stop_requested())
+            {
+                if(a_observer_limiter) a_observer_limiter->close();
+                if(notification_limiter) notification_limiter->close();
+                return;
+            }
+            enqueue([notification_limiter, a_observer_limiter, a_delivery]
+            {
+                a_delivery();
+                if(notification_limiter) notification_limiter->release();
+                if(a_observer_limiter) a_observer_limiter->release();
+            });
+        };
+
+        // The slot of the observer is taken first, so that a delivery waiting for its observer does not hold a slot
+        // of the notification that the deliveries to the other observers could use.
+        if(notification_limiter)
+        {
+            start = [notification_limiter, start = std::move(start)]{ notification_limiter->acquire(start); };
+        }
+        if(a_observer_limiter)
+        {
+            a_observer_limiter->acquire(std::move(start));
+        }
+        else
+        {
+            start();
+        }
+    }
+
+    /**
+     * @brief                   This method returns the function queuing the asynchronous deliveries of a
+     *                          notification, honouring set_busy_polling(), dispatch_mode::sharded, the bulkheads,
+     *                          set_fair_scheduling() and set_async_ordering(). It must be called with 'm_mutex'
+     *                          held, but the function may be called without.
+     * @param a_notification    The notification.
+     * @param a_mode            The dispatch mode of the post.
+     * @param a_group           The group of the observer.
+     * @param a_domain          The cache domain of the thread pool the deliveries should run in, or -1.
+     */
+    std::function<void(std::function<void()>)> executor_for(const int a_notification, const dispatch_mode a_mode,
+                                                            const int a_group, const int a_domain)
+    {
+        if(m_busy_polled.contains(a_notification))
+        {
+            return [dispatcher = m_busy_poll.get()](std::function<void()> a_task)
+            {
+                dispatcher->push(std::move(a_task));
+            };
+        }
+        if(a_mode == dispatch_mode::sharded)
+        {
+            if(!m_shards) m_shards = std::make_unique<shard_executor>(m_sharded_config);
+            return [shards = m_shards.get(), a_notification](std::function<void()> a_task)
+            {
+                shards->push(a_notification, std::move(a_task));
+            };
+        }
+        if(auto* isolated = bulkhead_for(a_notification, a_group))
+        {
+            return executor_for(a_notification, *isolated, isolated->get_fair_scheduler(), a_domain);
+        }
+        return executor_for(a_notification, m_pool, m_fair_scheduler, a_domain);
+    }
+
+    /**
+     * @brief                   This method returns the function queuing the asynchronous deliveries of a
+     *                          notification on an executor, honouring set_fair_scheduling() and set_async_ordering().
+     * @param a_notification    The notification.
+     * @param a_executor        The executor: the thread pool of the center or a bulkhead.
+     * @param a_scheduler       The fair scheduler of the executor.
+     * @param a_domain          The cache domain the deliveries should run in, or -1.
+     */
+    template<typename Executor>
+    std::function<void(std::function<void()>)> executor_for(const int a_notification, Executor& a_executor,
+                                                            const std::shared_ptr<fair_scheduler>& a_scheduler,
+                                                            const int a_domain)
+    {
+        if(m_fair_scheduling)
+        {
+            return [&a_executor, scheduler = a_scheduler, a_notification,
+                    serial = m_async_ordering == async_ordering::per_notification](std::function<void()> a_task)
+            {
+                scheduler->push(a_executor, a_notification, std::move(a_task), serial);
+            };
+        }
+        if(m_async_ordering == async_ordering::per_notification)
+        {
+            // Each executor has queues of its own, so a backlog in a bulkhead never holds deliveries on another.
+            auto& queue = m_serial_queues[a_notification][&a_executor];
+            if(!queue) queue = std::make_shared<serial_queue>();
+            return [&a_executor, queue](std::function<void()> a_task){ queue->push(a_executor, std::move(a_task)); };
+        }
+        return [&a_executor, a_domain](std::function<void()> a_task){ a_executor.push(std::move(a_task), a_domain); };
+    }
+
     /**
-     * @brief   Get a unique identifier.
+     * @brief                   This method binds a notification or a group to a bulkhead. It must be called with
+     *                          'm_mutex' held.
+     * @param a_bindings        The bindings of notifications or groups.
+     * @param a_key             The notification or group.
+     * @param a_bulkhead        The bulkhead, or -1 to remove the binding.
+     * @return                  0 if successful or an error code.
      */
-    int get_unique_id()
+    int bind(std::unordered_map<int, size_t>& a_bindings, const int a_key, const int a_bulkhead)
     {
-        std::lock_guard lock(m_mutex);
-        if (!m_released_ids.empty())
+        if(a_bulkhead == -1)
         {
-            const int id = m_released_ids.top();
-            m_released_ids.pop();
-            m_ids.insert(id);
-            return id;
+            a_bindings.erase(a_key);
+            return static_cast<int>(notifly_result::success);
         }
-        if(m_next_id == std::numeric_limits<int>::max()) return -1;
-
-        const int newId = m_next_id++;
-        m_ids.insert(newId);
-        return newId;
+        if(a_bulkhead < 0 || a_bulkhead >= static_cast<int>(m_bulkheads.size()))
+        {
+            return static_cast<int>(notifly_result::bulkhead_not_found);
+        }
+        a_bindings[a_key] = static_cast<size_t>(a_bulkhead);
+        return static_cast<int>(notifly_result::success);
     }
 
     /**
-     * @brief   Release an identifier.
+     * @brief                   This method returns the bulkhead the deliveries of an observer run on: the one of
+     *                          its notification, or else the one of its group, or nullptr.
+     * @param a_notification    The notification.
+     * @param a_group           The group of the observer.
      */
-    void release_id(const int id)
+    bulkhead* bulkhead_for(const int a_notification, const int a_group) const
     {
-        std::lock_guard lock(m_mutex);
-        m_ids.erase(id);
-        m_released_ids.push(id);
+        if(m_bulkheads.empty()) return nullptr;
+        if(const auto bound = m_notification_bulkheads.find(a_notification); bound != m_notification_bulkheads.end())
+        {
+            return m_bulkheads[bound->second].get();
+        }
+        if(const auto bound = m_group_bulkheads.find(a_group); bound != m_group_bulkheads.end())
+        {
+            return m_bulkheads[bound->second].get();
+        }
+        return nullptr;
     }
 
-private:
-    // Member variable that holds a set of all the IDs that have been used.
-    std::set<int> m_ids;
-    // Member variable that holds a stack of all the IDs that have been released.
-    std::stack<int> m_released_ids;
-    // Member variable that holds the next available ID.
-    int m_next_id = 1;
-    // Member variable that holds a mutex for thread safety.
-    std::mutex m_mutex;
-};
-
-/**
- * @brief   This class is a notification center that allows you to post notifications to a set of observers.
- */
-class notifly
-{
-public:
-	/**
-     * @brief   Constructor.
+    /**
+     * @brief           This method checks whether a group is in the range supported by the paused groups mask.
      */
-    notifly() = default;
+    static constexpr bool is_valid_group(const int a_group)
+    {
+        return a_group >= 0 && a_group < max_observer_groups;
+    }
 
     /**
-     * @brief                   This method adds a function callback as an observer to a named notification.
-     * @param   a_notification  The name of the notification you wish to observe.
-     * @param   a_method        The function callback.
-     * @return                  The observer id > 0 if successful or an error code
+     * @brief           This method returns the bit of the paused groups mask associated with a group.
      */
-    template<typename Callable>
-    int add_observer(int a_notification, Callable a_method)
+    static constexpr uint64_t group_bit(const int a_group)
     {
-        return add_observer(a_notification, std::function(std::move(a_method)));
+        return uint64_t{1} << a_group;
     }
 
     /**
-     * @brief                   This method adds a function callback as an observer to a named notification.
-     * @param   a_notification  The name of the notification you wish to observe.
-     * @param   a_method        The function callback.
-     * @return                  The observer id > 0 if successful or an error code
+     * @brief                   This method checks whether an observer depends, directly or not, on another one on a
+     *                          notification.
+     * @param a_notification    The notification.
+     * @param a_observer        The observer.
+     * @param a_dependency      The observer it may depend on.
+     * @return                  True if 'a_observer' depends on 'a_dependency'.
      */
-    template<typename Return, typename ...Args>
-    int add_observer(int a_notification, std::function<Return(Args ...)> a_method)
+    bool depends_on(const int a_notification, const int a_observer, const int a_dependency) const
     {
-        // Generate a unique string for the types of Args
-        std::string types;
-        (..., (types += stringType<Args>()));
-
-        // A lock_guard object is created, locking the mutex 'm_mutex' for the duration of the scope.
-        // This ensures that the following operations are thread-safe.
-        std::lock_guard a_lock(m_mutex);
+        const auto a_notification_iterator = m_observers.find(a_notification);
+        if(a_notification_iterator == m_observers.end()) return false;
 
-        if(m_observers.contains(a_notification))
+        std::unordered_map<int, const std::vector<int>*> dependencies;
+        for(const auto& observer : std::get<0>(a_notification_iterator->second))
         {
-            if (const auto& obs = std::get<0>(m_observers.at(a_notification)).front();
-                obs.get_types() != types)
-            {
-                return static_cast<int>(notifly_result::payload_type_not_match);
-            }
+            dependencies.emplace(observer.get_id(), &observer.m_dependencies);
         }
 
-        // A unique id is generated for the observer.
-        const auto id = m_id_manager.get_unique_id();
-        if(id == -1) return static_cast<int>(notifly_result::no_more_observer_ids);
-
-        // A 'notification_observer' object is created.
-        notification_observer observer(id, a_notification, types);
-
-        // A lambda function is being defined here. This lambda takes a single argument of type std::any and
-        // also returns std::any.
-        // The lambda captures 'a_method', which is a function passed from the surrounding scope.
-        auto lambda = [a_method](const std::any& any) -> std::any
+        std::vector<int> to_visit{a_observer};
+        std::set<int> visited;
+        while(!to_visit.empty())
         {
-            // The input std::any is cast to a std::tuple<Args...>. This assumes that the input std::any contains
-            // a std::tuple<Args...>.
-            auto message = std::any_cast<std::tuple<Args...>>(any);
+            const auto observer = to_visit.back();
+            to_visit.pop_back();
+            if(observer == a_dependency) return true;
+            if(!visited.insert(observer).second) continue;
 
-            // If the return type of the function is void (i.e., the function does not return anything),
-            if constexpr (std::is_same_v<Return, void>)
-            {
-                // The function is invoked with the arguments from the tuple 'message'.
-                std::apply(a_method, message);
-                return {};
-            }
-            else
+            if(const auto next = dependencies.find(observer); next != dependencies.end())
             {
-                // If the return type of the function is not void (i.e., the function returns something),
-                return std::apply(a_method, message);
+                to_visit.insert(to_visit.end(), next->second->begin(), next->second->end());
             }
-        };
-
-        // The callback function 'a_method' is moved into the 'm_callback_' member of the 'notification_observer' object.
-        // This is more efficient than copying, especially for large objects.
-        observer.m_callback = std::move(lambda);
-
-        // The 'notification_observer' object is added to the list of observers for the notification 'a_notification'.
-        std::get<0>(m_observers[a_notification]).push_back(observer);
-
-        // A tuple is created containing the notification and an iterator pointing to the last element in the list
-        // of observers.
-        // The '--' operator is used to get the iterator to the last element, as 'end()' returns an iterator to
-        // one past the last element.
-        const auto tuple = std::make_tuple(a_notification, --std::get<0>(m_observers[a_notification]).end());
+        }
+        return false;
+    }
 
-        // The tuple is added to the map 'm_observers_by_id' with the observer id as the key.
-        m_observers_by_id[id] = tuple;
+    /**
+     * @brief                   This method forgets dependencies between the observers of a notification.
+     * @param a_notification    The notification.
+     * @param a_count           The number of dependencies forgotten.
+     */
+    void drop_edges(const int a_notification, const size_t a_count)
+    {
+        const auto edges_iterator = m_dependency_edges.find(a_notification);
+        if(edges_iterator == m_dependency_edges.end()) return;
 
-        // The observer id is returned from the function.
-        return id;
+        edges_iterator->second -= std::min(a_count, edges_iterator->second);
+        if(edges_iterator->second == 0) m_dependency_edges.erase(edges_iterator);
     }
 
-	/**
-	 * @brief               This method removes an observer by iterator.
-	 * @param a_observer    The observer you wish to remove.
-	 * @return              0 if successful or an error code.
-	 */
-	int remove_observer(const int a_observer)
+    /**
+     * @brief                   This method erases a record of an observer from the list of observers of a
+     *                          notification, forgetting the notification once it has no observers left.
+     * @param a_notification    The notification of the record.
+     * @param a_iterator        The position of the record in the list of observers of the notification.
+     */
+    void erase_record(const int a_notification, const observer_itr_t a_iterator)
     {
-        // Check if the observer is not in the map of observers by id. If it's not, exit the function.
-        if(!m_observers_by_id.contains(a_observer)) return static_cast<int>(notifly_result::observer_not_found);
-
-        // Retrieve the tuple associated with the observer id from the map.
+        // Try to find the notification in the map of observers.
+        if (auto a_notification_iterator = m_observers.find(a_notification);
+                a_notification_iterator != m_observers.end())
         {
-            auto& [observer_id, iterator] = m_observers_by_id.at(a_observer);
-            // Lock the mutex to ensure thread safety during the operation.
-            std::lock_guard a_lock(m_mutex);
-
-            // Try to find the notification in the map of observers.
-            if (auto a_notification_iterator = m_observers.find(observer_id);
-                    a_notification_iterator != m_observers.end())
+            // The dependencies of the observer, and the ones on it, go away with it.
+            if(m_dependency_edges.contains(a_notification))
             {
-                // If the notification is found, erase the observer from the list of observers for that notification.
-                std::get<0>(a_notification_iterator->second).erase(iterator);
-
-                // If there are no more observers for this notification, erase the notification from the map of observers
-                // and also erase the notification from the map of payload types.
-                if(std::get<0>(a_notification_iterator->second).empty())
+                auto edges = a_iterator->m_dependencies.size();
+                for(auto& observer : std::get<0>(a_notification_iterator->second))
                 {
-                    m_observers.erase(a_notification_iterator);
+                    edges += std::erase(observer.m_dependencies, a_iterator->get_id());
                 }
+                drop_edges(a_notification, edges);
             }
-        }
 
-        // Finally, erase the observer from the map of observers by id.
-        m_observers_by_id.erase(a_observer);
-        // Release the observer id.
-        m_id_manager.release_id(a_observer);
+            // If the notification is found, erase the observer from the list of observers for that notification.
+            std::get<0>(a_notification_iterator->second).erase(a_iterator);
+            m_presence.remove(a_notification);
 
-        return static_cast<int>(notifly_result::success);
+            // If there are no more observers for this notification, erase the notification from the map of observers
+            // and forget its serial queue. Deliveries still queued keep the queue alive until they have run.
+            if(std::get<0>(a_notification_iterator->second).empty())
+            {
+                m_observers.erase(a_notification_iterator);
+                m_serial_queues.erase(a_notification);
+            }
+        }
     }
 
     /**
-     * @brief                       This method removes all observers from a given notification, removing the
-     *                              notification from being tracked outright.
-     * @param   a_notification      The name of the notification you wish to remove.
-     * @return                      The number of observers that were successfully removed or an error code.
+     * @brief               This method sets the circuit breaker shared by all the records of an observer.
+     * @param a_observer    The observer id.
+     * @param a_breaker     The breaker, or nullptr to remove it.
+     * @return              0 if successful or an error code.
      */
-    int remove_all_observers(const int a_notification)
+    int set_breaker(const int a_observer, const std::shared_ptr<circuit_breaker>& a_breaker)
     {
-        // Lock the mutex to ensure thread safety during the operation.
         std::lock_guard a_lock(m_mutex);
 
-        // Check if the notification is not in the map of observers. If it's not, exit the function.
-        if(!m_observers.contains(a_notification)) return 0;
-
-        // Get the list of observers for the given notification.
-        const auto observers_by_notification = std::get<0>(m_observers.at(a_notification));
-
-        // Get the number of observers for the given notification.
-        const auto ret = observers_by_notification.size();
-
-        // Iterate over all observers for the given notification.
-        for(const auto& observer: observers_by_notification)
+        const auto observer_iterator = m_observers_by_id.find(a_observer);
+        if(observer_iterator == m_observers_by_id.end())
         {
-            // Erase the observer from the map of observers by id.
-            m_observers_by_id.erase(observer.get_id());
-            // Release the observer id.
-            m_id_manager.release_id(observer.get_id());
+            return static_cast<int>(notifly_result::observer_not_found);
         }
 
-        // Erase the notification from the map of observers and the map of payload types.
-        m_observers.erase(a_notification);
-
-        return static_cast<int>(ret);
+        for(auto& [notification, iterator] : observer_iterator->second)
+        {
+            iterator->m_breaker = a_breaker;
+        }
+        return static_cast<int>(notifly_result::success);
     }
 
     /**
-     * @brief                   This method posts a notification to a set of observers. If successful, this function
-     *                          calls all callbacks associated with that notification and return true.
-     *                          If no such notification exists, this function will print a warning to the console and
-     *                          return false.
-     *
-     * @param a_notification    The name of the notification you wish to post.
-     * @param args              The payload associated with the specified notification.
-     * @param a_async           If false, this function will run in the same thread as the caller.
-     *                          If true, this function will run in a separate thread.
-     * @return                  Number of observers that were successfully notified or an error code.
+     * @brief               This method pauses or resumes a single observer.
+     * @param a_observer    The observer id.
+     * @param a_active      False to pause the observer, true to resume it.
+     * @return              0 if successful or an error code.
      */
-    template<typename ...Args>
-    int post_notification(const int a_notification, Args... args, const bool a_async = false)
+    int set_observer_active(const int a_observer, const bool a_active)
     {
-        // Generate a unique string for the types of Args
-        std::string types;
-        (..., (types += stringType<Args>()));
-        // This line is using a fold expression to concatenate the names of the types of the arguments (Args...).
-        // std::type_index is used to get a std::type_info for each type, and .name() gets the name of the type.
-        // The names are appended to the 'types' string.
-
-        // A lock_guard object is created, locking the mutex 'm_mutex' for the duration of the scope.
-        // This ensures that the following operations are thread-safe.
         std::lock_guard a_lock(m_mutex);
 
-        // Check if the types string matches the one saved in the map
-        if(!m_observers.contains(a_notification))
+        const auto observer_iterator = m_observers_by_id.find(a_observer);
+        if(observer_iterator == m_observers_by_id.end())
         {
-            return static_cast<int>(notifly_result::notification_not_found);
+            return static_cast<int>(notifly_result::observer_not_found);
         }
-        if (std::get<0>(m_observers[a_notification]).front().get_types() != types)
+
+        // The flag is only ever read and written with 'm_mutex' held.
+        for(auto& [notification, iterator] : observer_iterator->second)
         {
-            return static_cast<int>(notifly_result::payload_type_not_match);
+            iterator->set_active(a_active);
         }
+        return static_cast<int>(notifly_result::success);
+    }
 
-        // A std::tuple of the arguments is created and wrapped in a std::any.
-        auto payload = std::make_any<std::tuple<Args...>>(std::make_tuple(args...));
-
-        // The code attempts to find the notification 'a_notification' in the 'm_observers' map.
-        const auto a_notification_iterator = m_observers.find(a_notification);
-
-        // If the notification is found, it retrieves the list of observers for that notification.
-        const auto& a_notification_list = std::get<0>(a_notification_iterator->second);
+    /**
+     * @brief           This method returns a string identifying the types of the arguments 'Args'.
+     */
+    template <typename ...Args>
+    static std::string types_string()
+    {
+        // A fold expression concatenates the names of the types of the arguments (Args...).
+        std::string types;
+        (..., (types += stringType<Args>()));
+        return types;
+    }
 
-        // It then iterates over each observer in the list.
-        for (const auto& callback : a_notification_list)
+    /**
+     * @brief           This method wraps a function callback into a callback taking its arguments as a tuple wrapped
+     *                  in a std::any.
+     * @param a_method  The function callback.
+     * @return          The wrapped callback.
+     */
+    template<typename Return, typename ...Args>
+    static observer_state::function_t make_callback(std::function<Return(Args ...)> a_method)
+    {
+        // A lambda function is being defined here. This lambda takes a single argument of type std::any and
+        // also returns std::any.
+        // The lambda captures 'a_method', which is a function passed from the surrounding scope.
+        return [a_method = std::move(a_method)](const std::any& any) -> std::any
         {
-            // If 'a_async' is true, it pushes the callback function to the thread pool for asynchronous execution.
-            // The callback function is invoked with 'a_payload' as its argument.
-            if(a_async)
+            // The input std::any is cast to a std::tuple<Args...>. This assumes that the input std::any contains
+            // a std::tuple<Args...>.
+            auto message = std::any_cast<std::tuple<Args...>>(any);
+
+            // If the return type of the function is void (i.e., the function does not return anything),
+            if constexpr (std::is_same_v<Return, void>)
             {
-                m_pool.push([=]{ return callback.m_callback(payload);});
+                // The function is invoked with the arguments from the tuple 'message'.
+                std::apply(a_method, message);
+                return {};
             }
-            // If 'a_async' is false, it directly invokes the callback function with 'a_payload' as its argument.
             else
             {
-                callback.m_callback(payload);
+                // If the return type of the function is not void (i.e., the function returns something),
+                return std::apply(a_method, message);
             }
-        }
-        // If the notification is found and the callbacks are successfully invoked, it returns true.
-        return static_cast<int>(a_notification_list.size());
+        };
     }
 
     /**
-     * @brief   This method returns the default global notification center. You may alternatively create your
-     *          own notification center without using the default notification center.
+     * @brief               This method forgets the state of a removed observer, so that replace_observer() no longer
+     *                      finds it. It must be called with 'm_mutex' held.
+     * @param a_observer    The observer.
      */
-    static notifly& default_notifly()
+    void forget_state(const int a_observer)
     {
-        // Guaranteed to be destroyed. Instantiated on first use.
-        static notifly a_notification;
-
-        return a_notification;
+        std::unique_lock states_lock(m_states_mutex);
+        m_states.erase(a_observer);
     }
 
-private:
-    /** === Private types === **/
-	typedef std::list<notification_observer>::const_iterator observer_const_itr_t;
-	typedef std::tuple<int, observer_const_itr_t>  notification_tuple_t;
-	typedef std::tuple<std::list<notification_observer>, std::unique_ptr<std::mutex>> notification_info_t;
-
-    /** === Private methods === **/
     /**
      * @brief       This method returns a string representation of the type 'T'.
      * @tparam  T   The type to get the string representation of.
      * @return      A string representation of the type 'T'.
      */
     template <typename T>
-    std::string stringType() const
+    static std::string stringType()
     {
         const std::string type_name = std::type_index(typeid(T)).name();
         if (std::is_lvalue_reference_v<T>)
@@ -435,16 +5627,136 @@ private:
 	static std::shared_ptr<notifly> m_default_center;
     // 'm_observers' is a member variable that holds a map of notifications and their observers.
     std::unordered_map<int, notification_info_t> m_observers;
-    // 'm_observers_by_id' is a member variable that holds a map of observer ids and their associated tuples.
-    std::unordered_map<int, notification_tuple_t> m_observers_by_id;
+    // 'm_states' is a member variable that holds the state and the argument types of each observer by id, so that
+    // replace_observer() finds them without 'm_mutex'. It is written with both 'm_mutex' and 'm_states_mutex' held.
+    std::unordered_map<int, std::pair<std::shared_ptr<observer_state>, std::string>> m_states;
+    // 'm_states_mutex' is a member variable that holds a mutex protecting 'm_states'.
+    mutable std::shared_mutex m_states_mutex;
+    // 'm_observers_by_id' is a member variable that holds a map of observer ids and their associated tuples, one per
+    // notification the observer was added to.
+    std::unordered_map<int, std::vector<notification_tuple_t>> m_observers_by_id;
 
     // 'm_mutex' is a member variable that holds a mutex for thread safety.
 	typedef std::recursive_mutex mutex_t;
     mutable mutex_t m_mutex;
 
-    // 'm_thread_pool' is a member variable that holds a thread pool for asynchronous notifications.
-	PartyThreads::Pool m_pool{20};
-
     // 'm_id_manager' is a member variable that holds an id manager for managing unique observer ids.
     id_manager m_id_manager;
+
+    // 'm_presence' is a member variable that holds the number of observers of each notification, readable without
+    // taking the lock.
+    presence_filter m_presence;
+
+    // 'm_paused_groups' is a member variable that holds a bitmask of the observer groups that are currently paused.
+    std::atomic<uint64_t> m_paused_groups{0};
+
+    // 'm_sequences' is a member variable that holds the sequence number of the last post of each notification.
+    std::unordered_map<int, uint64_t> m_sequences;
+
+    // 'm_async_ordering' is a member variable that holds how asynchronous deliveries are ordered.
+    async_ordering m_async_ordering = async_ordering::none;
+
+    // 'm_adaptive_config' is a member variable that holds the thresholds used by dispatch_mode::adaptive.
+    adaptive_dispatch_config m_adaptive_config;
+
+    // 'm_parallel_config' is a member variable that holds the settings used by dispatch_mode::parallel.
+    parallel_dispatch_config m_parallel_config;
+
+    // 'm_fair_scheduling' is a member variable that holds whether the asynchronous deliveries are scheduled fairly
+    // between notifications.
+    bool m_fair_scheduling = false;
+
+    // 'm_fair_scheduler' is a member variable that holds the round-robin used under fair scheduling.
+    std::shared_ptr<fair_scheduler> m_fair_scheduler = std::make_shared<fair_scheduler>();
+
+    // 'm_shedder' is a member variable that holds the load shedder of the asynchronous deliveries, or nullptr.
+    std::shared_ptr<load_shedder> m_shedder;
+
+    // 'm_sheddable' is a member variable that holds the notifications whose deliveries may be shed.
+    std::set<int> m_sheddable;
+
+    // 'm_rings' is a member variable that holds the ring of each notification delivered through one.
+    std::unordered_map<int, std::shared_ptr<delivery_ring>> m_rings;
+
+    // 'm_notification_limiters' is a member variable that holds the bound on the concurrent asynchronous deliveries
+    // of each notification that has one.
+    std::unordered_map<int, std::shared_ptr<concurrency_limiter>> m_notification_limiters;
+
+    // 'm_dependency_edges' is a member variable that holds the number of dependencies between the observers of each
+    // notification that has any.
+    std::unordered_map<int, size_t> m_dependency_edges;
+
+    // 'm_serial_queues' is a member variable that holds the queue of each notification on each executor, used to run
+    // its asynchronous deliveries in posting order.
+    std::unordered_map<int, std::unordered_map<const void*, std::shared_ptr<serial_queue>>> m_serial_queues;
+
+    // 'm_failure_mutex' is a member variable that holds a mutex protecting the exception policy, the hooks and the
+    // captured exceptions.
+    std::mutex m_failure_mutex;
+
+    // 'm_exception_policy' is a member variable that holds what the center does when an observer throws.
+    exception_policy m_exception_policy = exception_policy::propagate;
+
+    // 'm_exception_hook' is a member variable that holds the hook receiving exceptions under exception_policy::report.
+    exception_hook_t m_exception_hook;
+
+    // 'm_exceptions' is a member variable that holds the exceptions captured so far.
+    std::vector<std::exception_ptr> m_exceptions;
+
+    // 'm_breaker_hook' is a member variable that holds the hook receiving the transitions of circuit breakers.
+    breaker_hook_t m_breaker_hook;
+
+    // 't_current_sequence' is a thread-local variable that holds the sequence number of the post being delivered.
+    static inline thread_local uint64_t t_current_sequence = 0;
+
+    // 't_current_state' is a thread-local variable that holds the state of the observer being delivered to.
+    static inline thread_local const observer_state* t_current_state = nullptr;
+
+    // 'm_stop_source' is a member variable that holds the source of the stop token linked to every observer.
+    std::stop_source m_stop_source;
+    // 'm_shutdown_mutex' is a member variable that holds a mutex ordering the queuing of parked deliveries with the
+    // destruction of the center.
+    std::shared_mutex m_shutdown_mutex;
+
+    // 'm_sharded_config' is a member variable that holds the settings of the shards of dispatch_mode::sharded.
+    sharded_dispatch_config m_sharded_config;
+
+    // 'm_shards' is a member variable that holds the shards of dispatch_mode::sharded, started by the first sharded
+    // post. Like the thread pool, it is declared after the members the deliveries refer to.
+    std::unique_ptr<shard_executor> m_shards;
+
+    // 'm_busy_poll_config' is a member variable that holds the settings of the busy-polling dispatcher.
+    busy_poll_config m_busy_poll_config;
+
+    // 'm_busy_polled' is a member variable that holds the notifications delivered by the busy-polling dispatcher.
+    std::set<int> m_busy_polled;
+
+    // 'm_busy_poll' is a member variable that holds the busy-polling dispatcher, started with the first notification
+    // using it.
+    std::unique_ptr<busy_poll_dispatcher> m_busy_poll;
+
+    // 'm_channels' is a member variable that holds the single producer, single consumer channel of each notification
+    // delivered through one.
+    std::unordered_map<int, std::unique_ptr<delivery_channel>> m_channels;
+
+    // 'm_realtime' is a member variable that holds the queue of try_post(), started by set_realtime_posting().
+    std::unique_ptr<realtime_queue> m_realtime;
+
+    // 'm_realtime_queue' is a member variable that holds the queue of try_post() too, read without the lock.
+    std::atomic<realtime_queue*> m_realtime_queue{nullptr};
+
+    // 'm_notification_bulkheads' is a member variable that holds the bulkhead each bound notification runs on.
+    std::unordered_map<int, size_t> m_notification_bulkheads;
+
+    // 'm_group_bulkheads' is a member variable that holds the bulkhead each bound group runs on.
+    std::unordered_map<int, size_t> m_group_bulkheads;
+
+    // 'm_bulkheads' is a member variable that holds the bulkheads. Like the thread pool, it is declared after the
+    // members the deliveries refer to.
+    std::vector<std::unique_ptr<bulkhead>> m_bulkheads;
+
+    // 'm_thread_pool' is a member variable that holds a thread pool for asynchronous notifications.
+    // It is declared last so that it is destroyed first: its workers are joined while the rest of the center, which
+    // the deliveries they run refer to, is still alive.
+    worker_pool m_pool;
 };
\ No newline at end of file
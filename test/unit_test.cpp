@@ -2,6 +2,7 @@
 // Created by Salvatore Rivieccio
 //
 #include <gtest/gtest.h>
+#include <future>
 
 #include "notifly.h"
 #include "unit_test.h"
@@ -366,4 +367,1312 @@ TEST(notifly, post_notification_with_deleted_payload)
         ASSERT_GE(ret, 0);  
     }
     promise.get_future().get();
-}
\ No newline at end of file
+}
+TEST(notifly, pause_and_resume_observer)
+{
+    notifly center;
+    std::atomic_int calls = 0;
+    const auto id = center.add_observer(poster, [&calls]{ ++calls; });
+
+    ASSERT_EQ(center.pause_observer(id), static_cast<int>(notifly_result::success));
+    const auto ret_paused = center.post_notification(poster);
+
+    ASSERT_EQ(center.resume_observer(id), static_cast<int>(notifly_result::success));
+    const auto ret_resumed = center.post_notification(poster);
+
+    center.remove_observer(id);
+
+    ASSERT_EQ(ret_paused, 0);
+    ASSERT_EQ(ret_resumed, 1);
+    ASSERT_EQ(calls, 1);
+    ASSERT_EQ(center.pause_observer(id), static_cast<int>(notifly_result::observer_not_found));
+}
+
+TEST(notifly, pause_and_resume_group)
+{
+    notifly center;
+    constexpr int group = 3;
+    std::atomic_int grouped_calls = 0;
+    std::atomic_int other_calls = 0;
+    const auto id_1 = center.add_observer(poster, [&grouped_calls]{ ++grouped_calls; }, group);
+    const auto id_2 = center.add_observer(poster, [&other_calls]{ ++other_calls; });
+
+    center.pause_group(group);
+    const auto ret_paused = center.post_notification(poster);
+    const auto paused = center.is_group_paused(group);
+
+    center.resume_group(group);
+    const auto ret_resumed = center.post_notification(poster);
+
+    center.remove_observer(id_1);
+    center.remove_observer(id_2);
+
+    ASSERT_TRUE(paused);
+    ASSERT_EQ(ret_paused, 1);
+    ASSERT_EQ(ret_resumed, 2);
+    ASSERT_EQ(grouped_calls, 1);
+    ASSERT_EQ(other_calls, 2);
+    ASSERT_EQ(center.pause_group(max_observer_groups),
+              static_cast<int>(notifly_result::invalid_group));
+}
+
+TEST(notifly, replace_observer)
+{
+    notifly center;
+    std::atomic_int old_calls = 0;
+    std::atomic_int new_calls = 0;
+    const auto id = center.add_observer(poster, [&old_calls](int a){ old_calls += a; });
+
+    const auto ret_before = center.post_notification<int>(poster, 1);
+    const auto ret_replace = center.replace_observer(id, [&new_calls](int a){ new_calls += a; });
+    const auto ret_after = center.post_notification<int>(poster, 2);
+    const auto ret_wrong_types = center.replace_observer(id, [](float){});
+
+    // The observer kept its id, so it can still be removed with it.
+    const auto ret_remove = center.remove_observer(id);
+
+    ASSERT_EQ(ret_before, 1);
+    ASSERT_EQ(ret_replace, static_cast<int>(notifly_result::success));
+    ASSERT_EQ(ret_after, 1);
+    ASSERT_EQ(ret_wrong_types, static_cast<int>(notifly_result::payload_type_not_match));
+    ASSERT_EQ(ret_remove, static_cast<int>(notifly_result::success));
+    ASSERT_EQ(old_calls, 1);
+    ASSERT_EQ(new_calls, 2);
+    ASSERT_EQ(center.replace_observer(id, [](int){}), static_cast<int>(notifly_result::observer_not_found));
+}
+
+TEST(notifly, replace_observer_during_post)
+{
+    notifly center;
+    std::atomic_int calls = 0;
+    const auto replaced = center.add_observer(second_poster, [&calls](int a){ calls += a; });
+
+    // A synchronous post holds the registry while it runs its observers, which replacing a callback does not need.
+    std::atomic_bool entered = false;
+    std::atomic_int ret_replace = -1;
+    std::atomic_bool replaced_during_post = false;
+    const auto blocking = center.add_observer(poster, [&](int)
+    {
+        entered = true;
+        replaced_during_post = eventually([&]{ return ret_replace.load() != -1; });
+    });
+
+    std::thread replacer([&]
+    {
+        while(!entered.load()) std::this_thread::yield();
+        ret_replace = center.replace_observer(replaced, [&calls](int a){ calls -= a; });
+    });
+    center.post_notification<int>(poster, 0);
+    replacer.join();
+
+    ASSERT_TRUE(replaced_during_post.load());
+    ASSERT_EQ(ret_replace.load(), static_cast<int>(notifly_result::success));
+    center.post_notification<int>(second_poster, 1);
+    ASSERT_EQ(calls.load(), -1);
+
+    center.remove_observer(replaced);
+    center.remove_observer(blocking);
+}
+
+TEST(notifly, add_observer_to_many_notifications)
+{
+    notifly center;
+    std::atomic_int calls = 0;
+    const std::vector<int> notifications = {poster, second_poster, third_poster, third_poster};
+    const auto id = center.add_observer(notifications, [&calls](int a){ calls += a; });
+
+    const auto ret_1 = center.post_notification<int>(poster, 1);
+    const auto ret_2 = center.post_notification<int>(second_poster, 2);
+    const auto ret_3 = center.post_notification<int>(third_poster, 4);
+
+    // Removing the subscription once removes it from every notification.
+    const auto ret_remove = center.remove_observer(id);
+    const auto ret_removed = center.post_notification<int>(second_poster, 8);
+
+    ASSERT_GE(id, 1);
+    ASSERT_EQ(ret_1, 1);
+    ASSERT_EQ(ret_2, 1);
+    ASSERT_EQ(ret_3, 1);
+    ASSERT_EQ(ret_remove, static_cast<int>(notifly_result::success));
+    ASSERT_EQ(ret_removed, static_cast<int>(notifly_result::notification_not_found));
+    ASSERT_EQ(calls, 7);
+}
+
+TEST(notifly, add_observer_to_many_notifications_type_mismatch)
+{
+    notifly center;
+    const auto id_1 = center.add_observer(second_poster, [](float){});
+    const std::vector<int> notifications = {poster, second_poster};
+    const auto id_2 = center.add_observer(notifications, [](int){});
+    const auto ret = center.post_notification<int>(poster, 1);
+
+    center.remove_observer(id_1);
+
+    ASSERT_EQ(id_2, static_cast<int>(notifly_result::payload_type_not_match));
+    ASSERT_EQ(ret, static_cast<int>(notifly_result::notification_not_found));
+}
+
+TEST(notifly, sequence_numbers)
+{
+    notifly center;
+    std::vector<uint64_t> sequences;
+    const auto id = center.add_observer(poster, [&sequences]{ sequences.push_back(notifly::current_sequence()); });
+
+    center.post_notification(poster);
+    center.pause_observer(id);
+    center.post_notification(poster);
+    center.resume_observer(id);
+    center.post_notification(poster);
+
+    const auto gaps = center.get_gap_count(id);
+    center.remove_observer(id);
+
+    // Posts skipped while paused still consume a sequence number, but they are not reported as gaps.
+    ASSERT_EQ(sequences, (std::vector<uint64_t>{1, 3}));
+    ASSERT_EQ(center.last_sequence(poster), 3u);
+    ASSERT_EQ(center.last_sequence(second_poster), 0u);
+    ASSERT_EQ(gaps, 0);
+    ASSERT_EQ(notifly::current_sequence(), 0u);
+}
+
+TEST(notifly, gap_count_of_dropped_deliveries)
+{
+    constexpr int posts = 500;
+    std::atomic_int calls = 0;
+
+    notifly center({1});
+    center.set_load_shedding({std::chrono::milliseconds(1), std::chrono::milliseconds(5)});
+    center.set_sheddable(poster, true);
+    const auto id = center.add_observer(poster, [&]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ++calls;
+    });
+
+    // Every post is dispatched to the observer, but the deliveries shed on the way are reported as gaps.
+    for(int i = 0; i < posts; ++i)
+    {
+        center.post_notification(poster, true);
+    }
+    ASSERT_TRUE(eventually([&]{ return calls.load() + center.get_gap_count(id) >= posts; }));
+    const auto gaps = center.get_gap_count(id);
+    load_shedding_stats stats;
+    ASSERT_TRUE(center.get_load_shedding_stats(stats));
+    center.remove_observer(id);
+
+    ASSERT_GT(gaps, 0);
+    ASSERT_EQ(gaps, static_cast<int64_t>(stats.shed));
+    ASSERT_EQ(calls.load() + gaps, posts);
+}
+
+TEST(notifly, ordered_async_deliveries)
+{
+    constexpr int posts = 1000;
+    std::mutex mutex;
+    std::vector<uint64_t> sequences;
+    std::promise<void> done;
+
+    // The center is declared last, so that its workers are joined before the state they use is destroyed.
+    notifly center;
+    const auto id = center.add_observer(poster, [&](const int a_index)
+    {
+        std::lock_guard lock(mutex);
+        sequences.push_back(notifly::current_sequence());
+        if(a_index == posts - 1) done.set_value();
+    });
+    ASSERT_EQ(center.set_ordered(id, true), static_cast<int>(notifly_result::success));
+
+    for(int i = 0; i < posts; ++i)
+    {
+        center.post_notification<int>(poster, i, true);
+    }
+    done.get_future().get();
+    center.remove_observer(id);
+
+    ASSERT_EQ(sequences.size(), static_cast<size_t>(posts));
+    ASSERT_TRUE(std::ranges::is_sorted(sequences));
+}
+
+TEST(notifly, ordered_observer_with_sync_posts)
+{
+    constexpr int posts = 300;
+    std::mutex mutex;
+    std::vector<int> received;
+    std::promise<void> done;
+
+    notifly center;
+    const auto id = center.add_observer(poster, [&](const int a_index)
+    {
+        std::lock_guard lock(mutex);
+        received.push_back(a_index);
+        if(received.size() == posts) done.set_value();
+    });
+    ASSERT_EQ(center.set_ordered(id, true), static_cast<int>(notifly_result::success));
+
+    // Synchronous deliveries bypass the reorder buffer, so the asynchronous ones must not wait for them.
+    std::vector<int> async_posted;
+    for(int i = 0; i < posts; ++i)
+    {
+        const auto async = i % 3 != 1;
+        if(async) async_posted.push_back(i);
+        ASSERT_EQ(center.post_notification<int>(poster, i, async), 1);
+    }
+    ASSERT_EQ(done.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    center.remove_observer(id);
+
+    std::vector<int> async_received;
+    std::ranges::copy_if(received, std::back_inserter(async_received),
+                         [](const int a_index){ return a_index % 3 != 1; });
+    ASSERT_EQ(async_received, async_posted);
+}
+
+TEST(notifly, per_notification_async_ordering)
+{
+    constexpr int posts = 200;
+    std::mutex mutex;
+    std::vector<int> first;
+    std::vector<int> second;
+    std::atomic_int remaining = 2 * posts;
+
+    notifly center;
+    center.set_async_ordering(async_ordering::per_notification);
+    const auto record = [&](std::vector<int>& a_received, const int a_index)
+    {
+        std::lock_guard lock(mutex);
+        a_received.push_back(a_index);
+        --remaining;
+    };
+    const auto id_1 = center.add_observer(poster, [&](const int a_index){ record(first, a_index); });
+    const auto id_2 = center.add_observer(second_poster, [&](const int a_index){ record(second, a_index); });
+
+    for(int i = 0; i < posts; ++i)
+    {
+        center.post_notification<int>(poster, i, true);
+        center.post_notification<int>(second_poster, i, true);
+    }
+    ASSERT_TRUE(eventually([&]{ return remaining <= 0; }));
+    center.remove_observer(id_1);
+    center.remove_observer(id_2);
+
+    ASSERT_EQ(first.size(), static_cast<size_t>(posts));
+    ASSERT_EQ(second.size(), static_cast<size_t>(posts));
+    ASSERT_TRUE(std::ranges::is_sorted(first));
+    ASSERT_TRUE(std::ranges::is_sorted(second));
+}
+
+TEST(notifly, exception_policy_propagate)
+{
+    notifly center;
+    std::atomic_int calls = 0;
+    const auto id_1 = center.add_observer(poster, []{ throw std::runtime_error("observer failed"); });
+    const auto id_2 = center.add_observer(poster, [&calls]{ ++calls; });
+
+    ASSERT_THROW(center.post_notification(poster), std::runtime_error);
+
+    // The observer after the faulty one was still notified.
+    ASSERT_EQ(calls, 1);
+    ASSERT_EQ(center.get_failure_count(id_1), 1);
+    ASSERT_EQ(center.get_failure_count(id_2), 0);
+
+    center.remove_observer(id_1);
+    center.remove_observer(id_2);
+}
+
+TEST(notifly, exception_policy_capture_and_report)
+{
+    notifly center;
+    std::atomic_int calls = 0;
+    const auto id_1 = center.add_observer(poster, []{ throw std::runtime_error("observer failed"); });
+    const auto id_2 = center.add_observer(poster, [&calls]{ ++calls; });
+
+    center.set_exception_policy(exception_policy::capture);
+    const auto ret_capture = center.post_notification(poster);
+    const auto captured = center.take_exceptions();
+
+    std::promise<int> reported;
+    center.set_exception_policy(exception_policy::report);
+    center.set_exception_hook([&reported](const int a_observer, int, const std::exception_ptr&)
+    {
+        reported.set_value(a_observer);
+    });
+    const auto ret_report = center.post_notification(poster, true);
+    const auto reported_observer = reported.get_future().get();
+
+    center.remove_observer(id_1);
+    center.remove_observer(id_2);
+
+    ASSERT_EQ(ret_capture, 1);
+    ASSERT_EQ(captured.size(), 1u);
+    ASSERT_THROW(std::rethrow_exception(captured.front()), std::runtime_error);
+    ASSERT_EQ(ret_report, 2);
+    ASSERT_EQ(reported_observer, id_1);
+}
+
+TEST(notifly, circuit_breaker)
+{
+    notifly center;
+    center.set_exception_policy(exception_policy::capture);
+
+    std::atomic_bool failing = true;
+    std::atomic_int calls = 0;
+    const auto id = center.add_observer(poster, [&]
+    {
+        ++calls;
+        if(failing) throw std::runtime_error("observer failed");
+    });
+
+    std::vector<std::pair<breaker_state, breaker_state>> transitions;
+    center.set_circuit_breaker_hook([&transitions](int, const breaker_state a_from, const breaker_state a_to)
+    {
+        transitions.emplace_back(a_from, a_to);
+    });
+
+    circuit_breaker_config config;
+    config.window = 4;
+    config.failure_rate = 0.5;
+    config.open_duration = std::chrono::milliseconds(50);
+    ASSERT_EQ(center.set_circuit_breaker(id, config), static_cast<int>(notifly_result::success));
+
+    // The fourth failure completes the window and trips the breaker, so the fifth post skips the observer.
+    for(int i = 0; i < 5; ++i)
+    {
+        center.post_notification(poster);
+    }
+    const auto calls_open = calls.load();
+    const auto state_open = center.get_circuit_breaker_state(id);
+
+    // Once the open duration has elapsed, a successful probe closes the breaker.
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    failing = false;
+    const auto ret_probe = center.post_notification(poster);
+    const auto state_closed = center.get_circuit_breaker_state(id);
+
+    center.remove_observer(id);
+
+    ASSERT_EQ(calls_open, 4);
+    ASSERT_EQ(state_open, breaker_state::open);
+    ASSERT_EQ(ret_probe, 1);
+    ASSERT_EQ(state_closed, breaker_state::closed);
+    ASSERT_EQ(transitions.size(), 3u);
+    ASSERT_EQ(transitions[0], std::make_pair(breaker_state::closed, breaker_state::open));
+    ASSERT_EQ(transitions[1], std::make_pair(breaker_state::open, breaker_state::half_open));
+    ASSERT_EQ(transitions[2], std::make_pair(breaker_state::half_open, breaker_state::closed));
+}
+
+TEST(notifly, remove_observer_skips_queued_deliveries)
+{
+    notifly center;
+    center.set_async_ordering(async_ordering::per_notification);
+
+    std::promise<void> started;
+    std::promise<bool> stopped;
+    std::atomic_int calls = 0;
+    const auto id = center.add_observer(poster, [&]
+    {
+        // The first delivery runs until the observer is removed, the others queue up behind it.
+        if(calls++ == 0)
+        {
+            started.set_value();
+            const auto token = notifly::current_stop_token();
+            stopped.set_value(eventually([&]{ return token.stop_requested(); }));
+        }
+    });
+
+    for(int i = 0; i < 10; ++i)
+    {
+        center.post_notification(poster, true);
+    }
+    ASSERT_EQ(started.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+    center.remove_observer(id);
+    ASSERT_TRUE(stopped.get_future().get());
+
+    // Let the queued deliveries drain: they must be skipped.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ASSERT_EQ(calls, 1);
+    ASSERT_FALSE(notifly::current_stop_token().stop_possible());
+}
+
+TEST(notifly, has_observers)
+{
+    notifly center;
+    const auto before = center.has_observers(poster);
+    const std::vector<int> notifications = {poster, second_poster};
+    const auto id = center.add_observer(notifications, sum_callback);
+    const auto during = center.has_observers(poster) && center.has_observers(second_poster);
+    const auto other = center.has_observers(third_poster);
+    center.remove_observer(id);
+    const auto after = center.has_observers(poster) || center.has_observers(second_poster);
+
+    ASSERT_FALSE(before);
+    ASSERT_TRUE(during);
+    ASSERT_FALSE(other);
+    ASSERT_FALSE(after);
+}
+
+TEST(notifly, post_lazy)
+{
+    notifly center;
+    int built = 0;
+    const auto factory = [&built]
+    {
+        ++built;
+        return std::make_tuple(5, 10);
+    };
+
+    const auto ret_nobody = center.post_lazy(poster, factory);
+
+    const auto id = center.add_observer(poster, sum_callback);
+    center.pause_observer(id);
+    const auto ret_paused = center.post_lazy(poster, factory);
+    const auto ret_wrong_types = center.post_lazy(poster, []{ return 1.0f; });
+
+    center.resume_observer(id);
+    const auto ret = center.post_lazy(poster, factory);
+
+    // The factory runs without the lock, so other threads can use the center meanwhile.
+    std::promise<void> added;
+    std::thread other;
+    bool added_while_building = false;
+    const auto ret_unlocked = center.post_lazy(poster, [&]
+    {
+        other = std::thread([&]
+        {
+            center.remove_observer(center.add_observer(second_poster, []{}));
+            added.set_value();
+        });
+        added_while_building = added.get_future().wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+        return std::make_tuple(5, 10);
+    });
+    other.join();
+
+    center.remove_observer(id);
+
+    ASSERT_EQ(ret_nobody, static_cast<int>(notifly_result::notification_not_found));
+    ASSERT_EQ(ret_paused, 0);
+    ASSERT_EQ(ret_wrong_types, static_cast<int>(notifly_result::payload_type_not_match));
+    ASSERT_EQ(ret, 1);
+    ASSERT_EQ(built, 1);
+    ASSERT_EQ(ret_unlocked, 1);
+    ASSERT_TRUE(added_while_building);
+}
+
+TEST(notifly, adaptive_dispatch)
+{
+    notifly center;
+    adaptive_dispatch_config config;
+    config.offload_above = std::chrono::milliseconds(2);
+    config.inline_below = std::chrono::milliseconds(1);
+    center.set_adaptive_dispatch(config);
+
+    const auto caller = std::this_thread::get_id();
+    std::atomic_int cheap_off_caller = 0;
+    std::atomic_int expensive_calls = 0;
+    const auto cheap = center.add_observer(poster, [&]{ cheap_off_caller += std::this_thread::get_id() != caller; });
+    const auto expensive = center.add_observer(poster, [&]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        ++expensive_calls;
+    });
+
+    // The first post runs both observers inline and measures them, the others offload the expensive one.
+    for(int i = 0; i < 5; ++i)
+    {
+        center.post_notification(poster, dispatch_mode::adaptive);
+    }
+    ASSERT_TRUE(eventually([&]{ return expensive_calls >= 5; }));
+
+    adaptive_dispatch_stats cheap_stats;
+    adaptive_dispatch_stats expensive_stats;
+    center.get_adaptive_dispatch_stats(cheap, cheap_stats);
+    center.get_adaptive_dispatch_stats(expensive, expensive_stats);
+    center.remove_observer(cheap);
+    center.remove_observer(expensive);
+
+    ASSERT_EQ(cheap_off_caller, 0);
+    ASSERT_FALSE(cheap_stats.offloaded);
+    ASSERT_EQ(cheap_stats.inline_deliveries, 5u);
+    ASSERT_TRUE(expensive_stats.offloaded);
+    ASSERT_EQ(expensive_stats.inline_deliveries, 1u);
+    ASSERT_EQ(expensive_stats.offloaded_deliveries, 4u);
+    ASSERT_EQ(expensive_stats.switches, 1u);
+    ASSERT_GE(expensive_stats.cost, std::chrono::milliseconds(2));
+}
+
+TEST(notifly, parallel_dispatch)
+{
+    constexpr int observers = 200;
+    notifly center;
+    parallel_dispatch_config config;
+    config.serial_below = 10;
+    config.chunk_size = 8;
+    center.set_parallel_dispatch(config);
+
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::atomic_int calls = 0;
+    std::vector<int> ids;
+    for(int i = 0; i < observers; ++i)
+    {
+        ids.push_back(center.add_observer(poster, [&]
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            std::lock_guard lock(mutex);
+            threads.insert(std::this_thread::get_id());
+            ++calls;
+        }));
+    }
+
+    const auto ret = center.post_notification(poster, dispatch_mode::parallel);
+
+    // Every observer has run by the time the post returns.
+    const auto calls_on_return = calls.load();
+
+    // With every observer paused, there is nothing to fork.
+    center.pause_group(0);
+    const auto paused_ret = center.post_notification(poster, dispatch_mode::parallel);
+    center.resume_group(0);
+    for(const auto id : ids)
+    {
+        center.remove_observer(id);
+    }
+
+    ASSERT_EQ(ret, observers);
+    ASSERT_EQ(calls_on_return, observers);
+    ASSERT_TRUE(threads.contains(std::this_thread::get_id()));
+    ASSERT_EQ(paused_ret, 0);
+    ASSERT_EQ(calls.load(), observers);
+}
+
+TEST(notifly, observer_dependencies)
+{
+    notifly center;
+
+    std::mutex mutex;
+    std::vector<std::string> order;
+    auto record = [&](const std::string& a_name)
+    {
+        std::lock_guard lock(mutex);
+        order.push_back(a_name);
+    };
+
+    const auto persist = center.add_observer(poster, [&]{ record("persist"); });
+    const auto enrich = center.add_observer(poster, [&]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        record("enrich");
+    });
+    const auto audit = center.add_observer(poster, [&]{ record("audit"); });
+    const auto other = center.add_observer(second_poster, []{});
+
+    ASSERT_EQ(center.add_dependency(persist, enrich), static_cast<int>(notifly_result::success));
+    ASSERT_EQ(center.add_dependency(enrich, persist), static_cast<int>(notifly_result::invalid_dependency));
+    ASSERT_EQ(center.add_dependency(persist, persist), static_cast<int>(notifly_result::invalid_dependency));
+    ASSERT_EQ(center.add_dependency(persist, other), static_cast<int>(notifly_result::invalid_dependency));
+
+    // The observers without dependencies run in parallel, and "persist" runs once "enrich" has.
+    ASSERT_EQ(center.post_notification(poster, dispatch_mode::parallel), 3);
+    ASSERT_EQ(order.size(), 3);
+    ASSERT_EQ(order.front(), "audit");
+    ASSERT_EQ(order.back(), "persist");
+
+    order.clear();
+    ASSERT_EQ(center.post_notification(poster), 3);
+    ASSERT_LT(std::ranges::find(order, "enrich"), std::ranges::find(order, "persist"));
+
+    // Removing the dependency lets the observers run in registration order again.
+    ASSERT_EQ(center.remove_dependency(persist, enrich), static_cast<int>(notifly_result::success));
+    order.clear();
+    ASSERT_EQ(center.post_notification(poster), 3);
+    ASSERT_EQ(order.front(), "persist");
+
+    center.remove_observer(persist);
+    center.remove_observer(enrich);
+    center.remove_observer(audit);
+    center.remove_observer(other);
+}
+
+TEST(notifly, observer_dependencies_from_pool_worker)
+{
+    notifly center({1});
+
+    std::atomic_int runs = 0;
+    const auto first = center.add_observer(poster, [&]{ ++runs; });
+    const auto second = center.add_observer(poster, [&]{ ++runs; });
+    ASSERT_EQ(center.add_dependency(second, first), static_cast<int>(notifly_result::success));
+
+    // The only pool worker waits for the graph, so it has to run the deliveries itself.
+    std::atomic_int notified = -1;
+    const auto relay = center.add_observer(second_poster, [&]
+    {
+        notified = center.post_notification(poster, dispatch_mode::parallel);
+    });
+    center.post_notification(second_poster, true);
+
+    ASSERT_TRUE(eventually([&]{ return notified.load() >= 0; }));
+    ASSERT_EQ(notified.load(), 2);
+    ASSERT_EQ(runs.load(), 2);
+
+    center.remove_observer(first);
+    center.remove_observer(second);
+    center.remove_observer(relay);
+}
+
+TEST(notifly, fair_scheduling)
+{
+    notifly center;
+    center.set_fair_scheduling(true);
+    center.set_notification_weight(poster, 4);
+
+    constexpr int flood = 400;
+    std::atomic_int started = 0;
+    std::atomic_int done = 0;
+    const auto noisy = center.add_observer(poster, [&]
+    {
+        ++started;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ++done;
+    });
+
+    std::promise<int> started_before;
+    const auto quiet = center.add_observer(second_poster, [&]{ started_before.set_value(started.load()); });
+
+    for(int i = 0; i < flood; ++i)
+    {
+        center.post_notification(poster, true);
+    }
+    center.post_notification(second_poster, true);
+
+    // The quiet notification is served within a turn or so, not after the backlog of the noisy one.
+    const auto before = started_before.get_future().get();
+    ASSERT_LT(before, flood / 2);
+
+    ASSERT_TRUE(eventually([&]{ return done.load() >= flood; }));
+    center.remove_observer(noisy);
+    center.remove_observer(quiet);
+}
+
+TEST(notifly, max_concurrency)
+{
+    notifly center;
+
+    std::atomic_int running = 0;
+    std::atomic_int peak = 0;
+    std::atomic_int calls = 0;
+    auto observer = [&]
+    {
+        const auto now = ++running;
+        auto previous = peak.load();
+        while(now > previous && !peak.compare_exchange_weak(previous, now)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        --running;
+        ++calls;
+    };
+
+    const auto limited = center.add_observer(poster, observer);
+    ASSERT_EQ(center.set_max_concurrency(limited, 2), static_cast<int>(notifly_result::success));
+
+    for(int i = 0; i < 20; ++i)
+    {
+        center.post_notification(poster, true);
+    }
+    ASSERT_GT(center.get_parked_deliveries(limited), 0);
+    ASSERT_TRUE(eventually([&]{ return calls.load() >= 20; }));
+    ASSERT_LE(peak.load(), 2);
+    ASSERT_EQ(center.get_parked_deliveries(limited), 0);
+
+    // The limit of a notification holds across all of its observers.
+    const auto other = center.add_observer(poster, observer);
+    center.set_notification_max_concurrency(poster, 1);
+    peak = 0;
+    calls = 0;
+    for(int i = 0; i < 10; ++i)
+    {
+        center.post_notification(poster, true);
+    }
+    ASSERT_TRUE(eventually([&]{ return calls.load() >= 20; }));
+    ASSERT_EQ(peak.load(), 1);
+
+    center.remove_observer(limited);
+    center.remove_observer(other);
+    ASSERT_EQ(center.set_max_concurrency(limited, 1), static_cast<int>(notifly_result::observer_not_found));
+}
+
+TEST(notifly, max_concurrency_without_head_of_line_blocking)
+{
+    notifly center;
+    center.set_notification_max_concurrency(poster, 2);
+
+    std::atomic_bool release = false;
+    std::atomic_int slow_calls = 0;
+    std::atomic_int fast_calls = 0;
+    const auto slow = center.add_observer(poster, [&]
+    {
+        while(!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ++slow_calls;
+    });
+    const auto fast = center.add_observer(poster, [&]{ ++fast_calls; });
+    ASSERT_EQ(center.set_max_concurrency(slow, 1), static_cast<int>(notifly_result::success));
+
+    // The deliveries waiting for the slow observer do not take the slots of the notification, so the fast observer
+    // still gets its posts.
+    constexpr int posts = 5;
+    for(int i = 0; i < posts; ++i)
+    {
+        center.post_notification(poster, true);
+    }
+    const auto unblocked = eventually([&]{ return fast_calls.load() >= posts; });
+    release = true;
+    ASSERT_TRUE(unblocked);
+    ASSERT_TRUE(eventually([&]{ return slow_calls.load() >= posts; }));
+
+    center.remove_observer(slow);
+    center.remove_observer(fast);
+}
+
+TEST(notifly, max_concurrency_across_executors_at_shutdown)
+{
+    std::atomic_int calls = 0;
+    {
+        notifly center;
+        ASSERT_TRUE(center.set_sharded_dispatch({1, false}));
+        center.set_notification_max_concurrency(poster, 1);
+
+        std::atomic_bool started = false;
+        center.add_observer(poster, [&]
+        {
+            if(!started.exchange(true)) std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            ++calls;
+        });
+
+        // The shard frees the slot of the notification once the thread pool is gone, resuming a delivery parked
+        // for it: the delivery is dropped rather than queued on the destroyed pool.
+        center.post_notification(poster, dispatch_mode::sharded);
+        ASSERT_TRUE(eventually([&]{ return started.load(); }));
+        center.post_notification(poster, dispatch_mode::async);
+    }
+    ASSERT_EQ(calls.load(), 1);
+}
+
+TEST(notifly, load_shedding)
+{
+    notifly center;
+    center.set_load_shedding({std::chrono::milliseconds(1), std::chrono::milliseconds(10)});
+    center.set_sheddable(poster, true);
+
+    constexpr int posts = 2000;
+    std::atomic_int calls = 0;
+    std::atomic_int kept = 0;
+    const auto sheddable = center.add_observer(poster, [&]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        ++calls;
+    });
+    const auto important = center.add_observer(second_poster, [&]{ ++kept; });
+
+    for(int i = 0; i < posts; ++i)
+    {
+        center.post_notification(poster, true);
+        if(i % 100 == 0) center.post_notification(second_poster, true);
+    }
+
+    load_shedding_stats stats;
+    ASSERT_TRUE(eventually([&]
+    {
+        center.get_load_shedding_stats(stats);
+        return calls.load() + static_cast<int>(stats.shed) >= posts && kept.load() >= posts / 100;
+    }));
+
+    // The standing queue was shed, while the deliveries of the notification that is not sheddable all ran.
+    ASSERT_GT(stats.shed, 0);
+    ASSERT_LT(calls.load(), posts);
+    ASSERT_EQ(kept.load(), posts / 100);
+    ASSERT_EQ(center.last_sequence(poster), posts);
+
+    // Each shed delivery shows up as a gap of the observer it was meant for.
+    ASSERT_EQ(center.get_gap_count(sheddable), static_cast<int64_t>(stats.shed));
+    ASSERT_EQ(center.get_gap_count(important), 0);
+
+    center.remove_observer(sheddable);
+    center.remove_observer(important);
+    center.remove_load_shedding();
+    ASSERT_FALSE(center.get_load_shedding_stats(stats));
+}
+
+TEST(notifly, sharded_dispatch)
+{
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::vector<int> received;
+    std::atomic_int delivered = 0;
+
+    notifly center;
+    ASSERT_TRUE(center.set_sharded_dispatch({4, false}));
+    const auto id = center.add_observer(poster, [&](const int a_value)
+    {
+        std::lock_guard lock(mutex);
+        threads.insert(std::this_thread::get_id());
+        received.push_back(a_value);
+        ++delivered;
+    });
+
+    for(int i = 0; i < 100; ++i)
+    {
+        center.post_notification<int>(poster, i, dispatch_mode::sharded);
+    }
+    ASSERT_FALSE(center.set_sharded_dispatch({2, false}));
+
+    ASSERT_TRUE(eventually([&]{ return delivered.load() >= 100; }));
+
+    // Every delivery of the notification ran on its shard, in posting order.
+    ASSERT_EQ(threads.size(), 1);
+    ASSERT_FALSE(threads.contains(std::this_thread::get_id()));
+    ASSERT_TRUE(std::ranges::is_sorted(received));
+
+    center.remove_observer(id);
+}
+
+TEST(notifly, busy_polling)
+{
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::vector<int> received;
+    std::atomic_int delivered = 0;
+
+    notifly center;
+    ASSERT_TRUE(center.set_busy_poll_dispatch({}));
+    const auto id = center.add_observer(poster, [&](const int a_value)
+    {
+        std::lock_guard lock(mutex);
+        threads.insert(std::this_thread::get_id());
+        received.push_back(a_value);
+        ++delivered;
+    });
+
+    center.set_busy_polling(poster, true);
+    ASSERT_FALSE(center.set_busy_poll_dispatch({0}));
+    for(int i = 0; i < 100; ++i)
+    {
+        center.post_notification<int>(poster, i, true);
+    }
+    center.set_busy_polling(poster, false);
+
+    // The deliveries queued before disabling still run, on the dispatcher thread, in posting order.
+    ASSERT_TRUE(eventually([&]{ return delivered.load() >= 100; }));
+    ASSERT_EQ(threads.size(), 1);
+    ASSERT_TRUE(std::ranges::is_sorted(received));
+
+    center.remove_observer(id);
+}
+
+TEST(notifly, wait_strategies)
+{
+    for(const auto strategy : {wait_strategy::spin, wait_strategy::spin_then_yield, wait_strategy::park})
+    {
+        std::atomic_int calls = 0;
+        notifly center({2, strategy, 16});
+        const auto id = center.add_observer(poster, [&calls]{ ++calls; });
+
+        for(int i = 0; i < 100; ++i)
+        {
+            center.post_notification(poster, true);
+            if(i % 10 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_TRUE(eventually([&]{ return calls.load() >= 100; }));
+        center.remove_observer(id);
+    }
+}
+
+TEST(notifly, cpu_affinity)
+{
+    const auto& topology = worker_pool::machine_topology();
+    ASSERT_FALSE(topology.cpus().empty());
+    ASSERT_FALSE(topology.domains().empty());
+    for(const auto& cpu : topology.cpus())
+    {
+        ASSERT_LT(cpu.domain, topology.domains().size());
+    }
+
+    for(const auto policy : {affinity_policy::compact, affinity_policy::scatter, affinity_policy::cache_domain})
+    {
+        std::atomic_int calls = 0;
+        notifly center({4, wait_strategy::park, 16, policy});
+        const auto id = center.add_observer(poster, [&calls]{ ++calls; });
+        ASSERT_EQ(center.set_observer_domain(id, 0), static_cast<int>(notifly_result::success));
+        ASSERT_EQ(center.set_observer_domain(id, static_cast<int>(topology.domains().size())),
+                  static_cast<int>(notifly_result::invalid_domain));
+
+        for(int i = 0; i < 50; ++i)
+        {
+            center.post_notification(poster, true);
+        }
+        ASSERT_TRUE(eventually([&]{ return calls.load() >= 50; }));
+        center.remove_observer(id);
+    }
+}
+
+TEST(notifly, bulkheads)
+{
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic_int slow_calls = 0;
+    std::promise<void> fast_done;
+
+    notifly center({2});
+    const auto isolated = center.add_bulkhead({{1}});
+    ASSERT_EQ(center.bind_notification(poster, isolated), static_cast<int>(notifly_result::success));
+    ASSERT_EQ(center.bind_notification(poster, isolated + 1), static_cast<int>(notifly_result::bulkhead_not_found));
+
+    const auto slow = center.add_observer(poster, [&]
+    {
+        released.wait();
+        ++slow_calls;
+    });
+    const auto fast = center.add_observer(second_poster, [&]{ fast_done.set_value(); });
+
+    // The backlog of the bulkhead does not hold back the deliveries running on the thread pool of the center.
+    for(int i = 0; i < 5; ++i)
+    {
+        center.post_notification(poster, true);
+    }
+    center.post_notification(second_poster, true);
+    ASSERT_EQ(fast_done.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    bulkhead_stats stats;
+    ASSERT_EQ(center.get_bulkhead_stats(isolated, stats), static_cast<int>(notifly_result::success));
+    ASSERT_EQ(stats.submitted, 5);
+    ASSERT_EQ(stats.completed, 0);
+
+    release.set_value();
+    ASSERT_TRUE(eventually([&]{ return slow_calls.load() >= 5; }));
+    center.remove_observer(slow);
+    center.remove_observer(fast);
+}
+
+TEST(notifly, bulkheads_keep_ordering_apart)
+{
+    constexpr int group = 3;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic_int slow_calls = 0;
+    std::vector<int> fast_received;
+    std::promise<void> fast_done;
+
+    notifly center({2});
+    center.set_async_ordering(async_ordering::per_notification);
+    const auto isolated = center.add_bulkhead({{1}});
+    ASSERT_EQ(center.bind_group(group, isolated), static_cast<int>(notifly_result::success));
+
+    // Both observers get every post in order, but the queue of the bulkhead does not hold back the thread pool.
+    const auto slow = center.add_observer(poster, [&](int)
+    {
+        released.wait();
+        ++slow_calls;
+    }, group);
+    const auto fast = center.add_observer(poster, [&](const int a_index)
+    {
+        fast_received.push_back(a_index);
+        if(fast_received.size() == 5) fast_done.set_value();
+    });
+    for(int i = 0; i < 5; ++i)
+    {
+        center.post_notification<int>(poster, i, true);
+    }
+    const auto fast_status = fast_done.get_future().wait_for(std::chrono::seconds(5));
+
+    release.set_value();
+    const auto slow_done = eventually([&]{ return slow_calls.load() >= 5; });
+    center.remove_observer(slow);
+    center.remove_observer(fast);
+
+    ASSERT_EQ(fast_status, std::future_status::ready);
+    ASSERT_EQ(fast_received, std::vector<int>({0, 1, 2, 3, 4}));
+    ASSERT_TRUE(slow_done);
+}
+
+TEST(notifly, elastic_pool)
+{
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic_int calls = 0;
+
+    executor_config config{1};
+    config.max_threads = 4;
+    config.target_queue_delay = std::chrono::milliseconds(1);
+    config.idle_timeout = std::chrono::milliseconds(20);
+    notifly center(config);
+    ASSERT_EQ(center.get_executor_stats().threads, 1);
+
+    const auto id = center.add_observer(poster, [&]
+    {
+        released.wait();
+        ++calls;
+    });
+
+    // The blocked deliveries make the queue delay grow past the target, so the pool grows to its maximum.
+    for(int i = 0; i < 8; ++i)
+    {
+        center.post_notification(poster, true);
+    }
+    ASSERT_TRUE(eventually([&]{ return center.get_executor_stats().threads >= 4; }));
+    auto stats = center.get_executor_stats();
+    ASSERT_EQ(stats.grown, 3);
+    ASSERT_EQ(stats.peak_threads, 4);
+    ASSERT_GT(stats.queue_delay, std::chrono::milliseconds(1));
+
+    // Once idle, it shrinks back to its minimum.
+    release.set_value();
+    ASSERT_TRUE(eventually([&]{ return calls.load() >= 8 && center.get_executor_stats().threads <= 1; }));
+    stats = center.get_executor_stats();
+    ASSERT_EQ(stats.shrunk, 3);
+    ASSERT_EQ(stats.queued, 0);
+    center.remove_observer(id);
+}
+
+TEST(notifly, mpmc_ring)
+{
+    mpmc_ring<int> ring(4);
+    ASSERT_EQ(ring.capacity(), 4);
+
+    std::vector<int> values = {1, 2, 3, 4, 5};
+    ASSERT_EQ(ring.try_push_bulk(values), 4);
+    int value = 6;
+    ASSERT_FALSE(ring.try_push(value));
+
+    std::vector<int> popped(3);
+    ASSERT_EQ(ring.try_pop_bulk(popped), 3);
+    ASSERT_EQ(popped, (std::vector<int>{1, 2, 3}));
+    ASSERT_TRUE(ring.try_push(value));
+    ASSERT_TRUE(ring.try_pop(value));
+    ASSERT_EQ(value, 4);
+    ASSERT_TRUE(ring.try_pop(value));
+    ASSERT_EQ(value, 6);
+    ASSERT_FALSE(ring.try_pop(value));
+
+    // Every value pushed by concurrent producers is popped exactly once by concurrent consumers.
+    mpmc_ring<int> shared(64);
+    std::atomic<long> sum = 0;
+    std::atomic_int consumed = 0;
+    std::vector<std::thread> threads;
+    for(int producer = 0; producer < 4; ++producer)
+    {
+        threads.emplace_back([&shared, producer]
+        {
+            for(int i = 1; i <= 10000; ++i)
+            {
+                int pushed = producer * 10000 + i;
+                while(!shared.try_push(pushed)) std::this_thread::yield();
+            }
+        });
+    }
+    for(int consumer = 0; consumer < 4; ++consumer)
+    {
+        threads.emplace_back([&]
+        {
+            std::vector<int> batch(8);
+            while(consumed.load() < 40000)
+            {
+                const auto count = shared.try_pop_bulk(batch);
+                for(size_t i = 0; i < count; ++i)
+                {
+                    sum += batch[i];
+                }
+                consumed += static_cast<int>(count);
+                if(count == 0) std::this_thread::yield();
+            }
+        });
+    }
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+    ASSERT_EQ(sum.load(), 40000L * 40001L / 2);
+}
+
+TEST(notifly, ring_delivery)
+{
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::mutex mutex;
+    std::vector<int> received;
+    std::atomic_int calls = 0;
+    std::atomic_int mismatched_sequences = 0;
+
+    notifly center;
+    center.set_ring_delivery(poster, 4);
+    const auto fast = center.add_observer(poster, [&](const int a_value)
+    {
+        std::lock_guard lock(mutex);
+        received.push_back(a_value);
+        if(notifly::current_sequence() != static_cast<uint64_t>(a_value)) ++mismatched_sequences;
+        ++calls;
+    });
+    const auto slow = center.add_observer(poster, [&](int)
+    {
+        released.wait();
+        ++calls;
+    });
+    // A paused observer never holds the ring back.
+    const auto paused = center.add_observer(poster, [&](int){ ++calls; });
+    ASSERT_EQ(center.pause_observer(paused), static_cast<int>(notifly_result::success));
+
+    for(int i = 1; i <= 4; ++i)
+    {
+        ASSERT_EQ(center.post_notification<int>(poster, i, true), 2);
+    }
+    // The slow observer has yet to consume the first post, so the ring is full.
+    ASSERT_EQ(center.post_notification<int>(poster, 5, true), static_cast<int>(notifly_result::ring_full));
+
+    release.set_value();
+    ASSERT_TRUE(eventually([&]{ return calls.load() >= 8; }));
+    for(int i = 5; i <= 100; ++i)
+    {
+        ASSERT_TRUE(eventually([&]
+        {
+            return center.post_notification<int>(poster, i, true) != static_cast<int>(notifly_result::ring_full);
+        }));
+    }
+    ASSERT_TRUE(eventually([&]{ return calls.load() >= 200; }));
+
+    std::lock_guard lock(mutex);
+    ASSERT_EQ(received.size(), 100);
+    for(int i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(received[i], i + 1);
+    }
+    ASSERT_EQ(mismatched_sequences.load(), 0);
+    center.remove_observer(fast);
+    center.remove_observer(slow);
+    center.remove_observer(paused);
+}
+
+TEST(notifly, spsc_channel)
+{
+    spsc_ring<int> ring(2);
+    int value = 1;
+    ASSERT_TRUE(ring.try_push(value));
+    value = 2;
+    ASSERT_TRUE(ring.try_push(value));
+    ASSERT_FALSE(ring.try_push(value));
+    ASSERT_EQ(ring.free_slots(), 0);
+    ASSERT_TRUE(ring.try_pop(value));
+    ASSERT_EQ(value, 1);
+    ASSERT_EQ(ring.free_slots(), 1);
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::vector<int> received;
+    std::atomic_int calls = 0;
+
+    notifly center;
+    center.set_spsc_channel(poster, 4);
+    const auto id = center.add_observer(poster, [&](const int a_value)
+    {
+        released.wait();
+        received.push_back(a_value);
+        ++calls;
+    });
+
+    // The first delivery blocks the thread of the channel, so the ring fills up behind it.
+    ASSERT_EQ(center.post_notification<int>(poster, 0, true), 1);
+    int posted = 1;
+    while(center.post_notification<int>(poster, posted, true) == 1)
+    {
+        ++posted;
+    }
+    ASSERT_GE(posted, 4);
+    ASSERT_LE(posted, 5);
+
+    release.set_value();
+    ASSERT_TRUE(eventually([&]{ return calls.load() >= posted; }));
+    for(int i = 0; i < 1000; ++i)
+    {
+        ASSERT_TRUE(eventually([&]{ return center.post_notification<int>(poster, posted, true) == 1; }));
+        ++posted;
+    }
+    ASSERT_TRUE(eventually([&]{ return calls.load() >= posted; }));
+    for(int i = 0; i < posted; ++i)
+    {
+        ASSERT_EQ(received[i], i);
+    }
+
+    center.set_spsc_channel(poster, 0);
+    ASSERT_EQ(center.post_notification<int>(poster, posted, true), 1);
+    ASSERT_TRUE(eventually([&]{ return calls.load() > posted; }));
+    center.remove_observer(id);
+}
+
+TEST(notifly, realtime_try_post)
+{
+    struct sample
+    {
+        float left;
+        float right;
+    };
+
+    std::atomic_bool entered = false;
+    std::atomic_int calls = 0;
+    std::vector<int> frames;
+    float sum = 0;
+
+    notifly center;
+    ASSERT_EQ(center.try_post<int>(poster, 0), static_cast<int>(notifly_result::realtime_disabled));
+    ASSERT_TRUE(center.set_realtime_posting(realtime_config{4, std::chrono::microseconds(100)}));
+    ASSERT_FALSE(center.set_realtime_posting(realtime_config{}));
+    ASSERT_EQ(center.try_post<int>(poster, 0), static_cast<int>(notifly_result::notification_not_found));
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    center.add_observer(poster, [&](const int a_frame, const sample a_sample)
+    {
+        entered = true;
+        released.wait();
+        frames.push_back(a_frame);
+        sum += a_sample.left + a_sample.right;
+        ++calls;
+    });
+
+    // The first post blocks the dispatcher thread, so the ring fills up behind it.
+    ASSERT_EQ((center.try_post<int, sample>(poster, 0, {1, 2})), static_cast<int>(notifly_result::success));
+    ASSERT_TRUE(eventually([&]{ return entered.load(); }));
+    int posted = 1;
+    while(center.try_post<int, sample>(poster, posted, {1, 2}) == static_cast<int>(notifly_result::success))
+    {
+        ++posted;
+    }
+    ASSERT_EQ(posted, 5);
+    ASSERT_EQ(center.get_realtime_stats().refused, 1);
+
+    // A payload of the wrong types is queued, but the dispatcher thread cannot post it.
+    release.set_value();
+    ASSERT_TRUE(eventually([&]
+    {
+        return center.try_post<int>(poster, 0) == static_cast<int>(notifly_result::success);
+    }));
+    ASSERT_TRUE(eventually([&]{ return center.get_realtime_stats().failed != 0 && calls.load() >= posted; }));
+    for(int i = 0; i < posted; ++i)
+    {
+        ASSERT_EQ(frames[i], i);
+    }
+    ASSERT_EQ(sum, 3.0f * static_cast<float>(posted));
+    ASSERT_EQ(center.get_realtime_stats().failed, 1);
+}
+
+TEST(notifly, realtime_try_post_throwing_observer)
+{
+    std::atomic_int calls = 0;
+
+    notifly center;
+    ASSERT_TRUE(center.set_realtime_posting(realtime_config{}));
+    const auto id = center.add_observer(poster, [&](const int a_value)
+    {
+        ++calls;
+        if(a_value == 0) throw std::runtime_error("observer failure");
+    });
+
+    // The exception of the first post neither terminates the dispatcher thread nor holds back the next post.
+    ASSERT_EQ(center.try_post<int>(poster, 0), static_cast<int>(notifly_result::success));
+    ASSERT_EQ(center.try_post<int>(poster, 1), static_cast<int>(notifly_result::success));
+    ASSERT_TRUE(eventually([&]{ return calls.load() >= 2; }));
+    ASSERT_TRUE(eventually([&]{ return center.get_realtime_stats().failed == 1; }));
+    center.remove_observer(id);
+}
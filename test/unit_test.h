@@ -77,4 +77,18 @@ int no_params()
 void void_no_params()
 {
     printf("No params\n");
-}
\ No newline at end of file
+}
+
+// Wait for a condition to hold, polling it every millisecond for at most ten seconds, so that a lost delivery fails
+// the test instead of hanging it. Returns whether the condition holds.
+template<typename Condition>
+bool eventually(Condition a_condition)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while(!a_condition())
+    {
+        if(std::chrono::steady_clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}